@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <yloc/yloc.h>
+
+using namespace yloc;
+
+/* device whose power changes now and then, like a GPU under a varying load */
+class NoisyAdapter : public Adapter
+{
+public:
+    explicit NoisyAdapter(unsigned seed) : m_rng{seed} {}
+
+    std::optional<uint64_t> power() const override
+    {
+        if (m_rng() % 4 == 0) {
+            m_power += m_rng() % 2001 - 1000;
+        }
+        return m_power;
+    }
+
+    std::optional<uint64_t> load() const override { return m_rng() % 10 == 0 ? m_rng() % 100 : 50; }
+
+private:
+    mutable std::mt19937 m_rng;
+    mutable uint64_t m_power{250000000};
+};
+
+using values_t = std::map<std::pair<vertex_descriptor_t, size_t>, uint64_t>;
+
+/* splits a binary feed into its frames ([varint size][payload]) */
+static std::vector<std::string> split_frames(const std::string &feed)
+{
+    std::vector<std::string> frames{};
+    for (size_t p = 0; p < feed.size();) {
+        size_t start = p;
+        uint64_t size = 0;
+        for (int shift = 0; feed[p] & 0x80; shift += 7) {
+            size |= static_cast<uint64_t>(feed[p++] & 0x7f) << shift;
+        }
+        size |= static_cast<uint64_t>(feed[p] & 0x7f) << (7 * (p - start));
+        p += 1 + size;
+        frames.push_back(feed.substr(start, p - start));
+    }
+    return frames;
+}
+
+/* decodes frames, returns the number of frames whose values differ from the truth */
+static size_t decode(const std::string &name, const std::vector<std::string> &frames, const std::vector<values_t> &truth)
+{
+    ChangeFeedDecoder decoder{};
+    values_t values{};
+    size_t decoded = 0, wrong = 0;
+    std::vector<uint64_t> skipped{};
+    for (const auto &data : frames) {
+        std::optional<feed_frame> frame;
+        decoder.decode(data.data(), data.size(), frame);
+        if (!frame.has_value()) {
+            continue;
+        }
+        if (frame->keyframe) {
+            values.clear();
+        }
+        for (const auto &[vd, value] : frame->values) {
+            values[{vd, value.first}] = value.second;
+        }
+        ++decoded;
+        wrong += values != truth[frame->sequence];
+    }
+    std::cout << name << ": " << decoded << " of " << frames.size() << " frames decoded, " << wrong << " with wrong values\n";
+    return wrong;
+}
+
+int main()
+{
+    Graph g{};
+    std::vector<std::pair<SampledAdapter *, Adapter *>> devices{};
+    for (unsigned i = 0; i < 8; ++i) {
+        auto vd = g.add_vertex("gpu:" + std::to_string(i));
+        g[vd].type = GPU::ptr();
+        auto *adapter = new NoisyAdapter{i};
+        g[vd].add_adapter(adapter);
+        devices.emplace_back(sampled_adapter(g, vd), adapter);
+    }
+
+    // a keyframe every 10 frames, the values after every frame are the truth to compare with
+    std::ostringstream out{};
+    ChangeFeed feed{g, out, feed_format::BINARY, 10};
+    std::vector<values_t> truth{};
+    for (int t = 0; t < 100; ++t) {
+        for (auto [sampled, adapter] : devices) {
+            sampled->sample_from(adapter);
+        }
+        feed.emit();
+        values_t values{};
+        for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+            for (size_t i = 0; i < dynamic_properties().size(); ++i) {
+                if (auto latest = find_sampled_adapter(g[vd])->latest(i)) {
+                    values[{vd, i}] = latest->value;
+                }
+            }
+        }
+        truth.push_back(values);
+    }
+    auto frames = split_frames(out.str());
+    std::cout << frames.size() << " frames, " << out.str().size() << " bytes\n";
+
+    size_t wrong = decode("complete feed", frames, truth);
+
+    // a lost frame: the decoder skips the deltas until the next keyframe
+    auto lost = frames;
+    lost.erase(lost.begin() + 33);
+    wrong += decode("frame 33 lost", lost, truth);
+
+    // a truncated frame (its size prefix fits the shorter payload): it is malformed and
+    // rejected, so are the deltas until the next keyframe
+    auto truncated = frames;
+    std::string payload = frames[57].substr(1, (frames[57].size() - 1) / 2);
+    truncated[57] = static_cast<char>(payload.size()) + payload;
+    wrong += decode("frame 57 truncated", truncated, truth);
+
+    // joining a running feed: decoding starts with the first keyframe
+    wrong += decode("joined at frame 15", std::vector<std::string>{frames.begin() + 15, frames.end()}, truth);
+    return wrong == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
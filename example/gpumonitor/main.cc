@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 #include <optional>
 #include <thread>
@@ -10,7 +11,8 @@ using namespace yloc;
 
 int main(int argc, char *argv[])
 {
-    yloc::init();
+    // dynamic properties are sampled in the background, reads return the latest sample
+    yloc::init(YLOC_ONGOING);
 
     Graph &g = yloc::root_graph();
 
@@ -18,6 +20,15 @@ int main(int argc, char *argv[])
         return g[v].type->is_a<GPU>();
     });
 
+    // with --ndjson, only print values that changed since the last second
+    if (argc > 1 && std::strcmp(argv[1], "--ndjson") == 0) {
+        ChangeFeed feed{g, std::cout, feed_format::NDJSON};
+        while (1) {
+            feed.emit();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        }
+    }
+
     while (1) {
         size_t gpu = 0;
         for (auto vd : boost::make_iterator_range(boost::vertices(fgv))) {
@@ -33,10 +44,10 @@ int main(int argc, char *argv[])
             print_property(g, vd, "frequency");
             print_property(g, vd, "load");
             print_property(g, vd, "power");
-            // these properties are blocking:
-            // PRINT_PROPERTY(pci_throughput);
-            // PRINT_PROPERTY(pci_throughput_read);
-            // PRINT_PROPERTY(pci_throughput_write);
+            // these properties are blocking, but sampled with YLOC_ONGOING:
+            print_property(g, vd, "pci_throughput");
+            print_property(g, vd, "pci_throughput_read");
+            print_property(g, vd, "pci_throughput_write");
             gpu++;
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
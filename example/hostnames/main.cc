@@ -0,0 +1,47 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <yloc/yloc.h>
+
+// this example builds the system hierarchy of a synthetic SuperMUC-like job with 100k ranks,
+// 48 ranks per node on 8 islands with 20 racks of 4 chassis, e.g.
+//   ./example-hostnames [ranks] [pattern]
+int main(int argc, char *argv[])
+{
+    int nranks = argc > 1 ? std::stoi(argv[1]) : 100000;
+    std::regex pattern{argc > 2 ? argv[2] : yloc::supermuc_hostname_pattern, std::regex::optimize};
+
+    const int ranks_per_node = 48;
+    std::vector<std::string> hostnames(nranks);
+    char hostname[32];
+    for (int rank = 0; rank < nranks; ++rank) {
+        int node = rank / ranks_per_node;
+        std::snprintf(hostname, sizeof(hostname), "i%02dr%02dc%02ds%02d", node / 1280 % 100, node / 64 % 20, node / 16 % 4, node % 16);
+        hostnames[rank] = hostname;
+    }
+
+    yloc::Graph g{};
+
+    auto start = std::chrono::steady_clock::now();
+    yloc_status_t status = yloc::make_hostname_hierarchy(g, hostnames, pattern);
+    auto end = std::chrono::steady_clock::now();
+
+    if (status != YLOC_STATUS_SUCCESS) {
+        std::cerr << "no hostname matches the pattern\n";
+        return EXIT_FAILURE;
+    }
+
+    size_t machines = 0;
+    for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+        machines += g[vd].type->is_a<yloc::Node>();
+    }
+    std::cout << nranks << " ranks, " << machines << " machines, " << boost::num_vertices(g) << " vertices, "
+              << boost::num_edges(g) << " edges in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+
+    return EXIT_SUCCESS;
+}
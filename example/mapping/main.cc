@@ -0,0 +1,67 @@
+#include <iostream>
+#include <vector>
+
+#include <mpi.h>
+
+#include <yloc/mpi_mapping.h>
+#include <yloc/yloc.h>
+
+// this example reorders the ranks of an application in which every process communicates
+// with the process half the job away, e.g.
+//   mpirun --oversubscribe --bind-to core -np 8 ./example-mapping
+int main(int argc, char *argv[])
+{
+    MPI_Init(&argc, &argv);
+
+    yloc::init();
+
+    yloc::Graph &g = yloc::root_graph();
+
+    int size, rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // heavy traffic between i and i + size / 2, light traffic between neighbors
+    std::vector<uint64_t> matrix(size * size, 0);
+    for (int i = 0; i < size; ++i) {
+        matrix[i * size + (i + size / 2) % size] += 1000;
+        matrix[i * size + (i + 1) % size] += 1;
+    }
+    for (int i = 0; i < size; ++i) {
+        matrix[i * size + i] = 0;
+    }
+
+    auto perm = yloc::compute_rank_mapping(g, MPI_COMM_WORLD, matrix);
+
+    if (rank == 0) {
+        auto dist = yloc::hop_distances(g, yloc::rank_vertices(g, MPI_COMM_WORLD));
+        std::vector<int> identity(size);
+        for (int i = 0; i < size; ++i) {
+            identity[i] = i;
+        }
+        std::cout << "cost of identity mapping: " << yloc::mapping_cost(matrix, dist, identity) << '\n';
+        std::cout << "cost of yloc mapping:     " << yloc::mapping_cost(matrix, dist, perm) << '\n';
+        for (int i = 0; i < size; ++i) {
+            std::cout << "process " << i << " -> location of rank " << perm[i] << '\n';
+        }
+    }
+
+    MPI_Comm newcomm;
+    yloc::reorder_comm(g, MPI_COMM_WORLD, matrix, &newcomm);
+    int new_rank;
+    MPI_Comm_rank(newcomm, &new_rank);
+
+    auto adj = yloc::dist_graph_adjacency_of(matrix, new_rank);
+    MPI_Comm graph_comm;
+    MPI_Dist_graph_create_adjacent(newcomm, adj.sources.size(), adj.sources.data(), adj.source_weights.data(),
+                                   adj.destinations.size(), adj.destinations.data(), adj.destination_weights.data(),
+                                   MPI_INFO_NULL, 0, &graph_comm);
+
+    MPI_Comm_free(&graph_comm);
+    MPI_Comm_free(&newcomm);
+
+    yloc::finalize();
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <yloc/series_file.h>
+
+using namespace yloc;
+
+/* samples of typical and extreme series, the writer must reproduce all of them exactly */
+static std::vector<std::vector<sample>> make_series(size_t n)
+{
+    std::mt19937_64 rng{42};
+    std::vector<std::vector<sample>> series(6);
+    int64_t t = 1700000000000000000;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t regular = t + static_cast<int64_t>(i) * 100000000;                   // 100 ms
+        int64_t jittered = regular + static_cast<int64_t>(rng() % 2000000) - 1000000; // +- 1 ms
+        series[0].push_back({70000, regular});                                       // constant
+        series[1].push_back({70000 + rng() % 1000, jittered});                       // noisy power
+        series[2].push_back({i * 4096, regular});                                    // counter
+        series[3].push_back({rng(), regular + static_cast<int64_t>(i * i) * 1000});  // random, growing gaps
+        series[4].push_back({i % 2 ? UINT64_MAX : 0, regular});                      // all bits flip
+        series[5].push_back({i, i % 3 == 0 ? regular : regular + 1});                // alternating deltas
+    }
+    series[5].back().time = INT64_MAX; // huge delta-of-delta
+    return series;
+}
+
+static bool check(SeriesFileReader &reader, const std::vector<std::vector<sample>> &series, size_t expected)
+{
+    bool ok = true;
+    for (size_t s = 0; s < series.size(); ++s) {
+        auto id = reader.find("vertex" + std::to_string(s), "power");
+        auto samples = id.has_value() ? reader.scan(*id, INT64_MIN, INT64_MAX) : std::vector<sample>{};
+        bool equal = samples.size() == std::min(expected, series[s].size());
+        for (size_t i = 0; equal && i < samples.size(); ++i) {
+            equal = samples[i].value == series[s][i].value && samples[i].time == series[s][i].time;
+        }
+        std::cout << "  series " << s << ": " << samples.size() << " samples " << (equal ? "ok" : "MISMATCH") << "\n";
+        ok = ok && equal;
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path = argc > 1 ? argv[1] : (std::filesystem::temp_directory_path() / "yloc-series-example").string();
+    const size_t n = 5000; // several full blocks and a partial one per series
+    auto series = make_series(n);
+
+    // round trip of a closed file
+    SeriesFileWriter writer{};
+    if (writer.open(path) != YLOC_STATUS_SUCCESS) {
+        std::cerr << "cannot create " << path << "\n";
+        return EXIT_FAILURE;
+    }
+    for (size_t s = 0; s < series.size(); ++s) {
+        writer.add_series("vertex" + std::to_string(s), "power");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (uint32_t s = 0; s < series.size(); ++s) {
+            writer.append(s, series[s][i].time, series[s][i].value);
+        }
+    }
+    writer.close();
+
+    auto size = std::filesystem::file_size(path);
+    std::cout << "closed file: " << size << " bytes, " << static_cast<double>(series.size() * n * sizeof(sample)) / size << "x smaller than raw samples\n";
+    SeriesFileReader reader{};
+    bool ok = reader.open(path) == YLOC_STATUS_SUCCESS && check(reader, series, n);
+
+    // a file cut within its last blocks (e.g. of a killed process) keeps all complete blocks
+    std::filesystem::resize_file(path, size * 3 / 4);
+    SeriesFileReader truncated{};
+    std::cout << "truncated file:\n";
+    ok = truncated.open(path) == YLOC_STATUS_SUCCESS && ok;
+    for (const auto &info : truncated.series()) {
+        auto samples = truncated.scan(info.id, INT64_MIN, INT64_MAX);
+        auto &expected = series[std::stoul(info.vertex.substr(6))];
+        bool prefix = samples.size() <= expected.size();
+        for (size_t i = 0; prefix && i < samples.size(); ++i) {
+            prefix = samples[i].value == expected[i].value && samples[i].time == expected[i].time;
+        }
+        std::cout << "  " << info.vertex << ": " << samples.size() << " samples " << (prefix ? "ok" : "MISMATCH") << "\n";
+        ok = ok && prefix;
+    }
+
+    std::remove(path.c_str());
+    std::cout << (ok ? "round trip ok" : "round trip FAILED") << "\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,59 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <yloc/yloc.h>
+
+using namespace yloc;
+
+// this example prints the switch hierarchy of a Slurm topology.conf and the switch hops
+// between some of its nodes, e.g.
+//   YLOC_TOPOLOGY_CONF=example/slurm/topology.conf ./example-slurm node001 node002 node009 node032
+int main(int argc, char *argv[])
+{
+    if (std::getenv("YLOC_TOPOLOGY_CONF") == nullptr) {
+        std::cerr << "YLOC_TOPOLOGY_CONF is not set\n";
+        return EXIT_FAILURE;
+    }
+
+    yloc::init();
+
+    Graph &g = root_graph();
+
+    for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+        if (!g[vd].type->is_a<Switch>()) {
+            continue;
+        }
+        size_t switches = 0, machines = 0;
+        for (auto e : boost::make_iterator_range(boost::out_edges(vd, g))) {
+            if (g[e].type == edge_type::CHILD) {
+                switches += g[boost::target(e, g)].type->is_a<Switch>();
+                machines += g[boost::target(e, g)].type->is_a<Node>();
+            }
+        }
+        std::cout << g[vd].to_string() << " (link speed " << g[vd].get<uint64_t>("link_speed").value_or(0) << "): "
+                  << switches << " switches, " << machines << " machines\n";
+    }
+
+    std::vector<vertex_descriptor_t> machines{};
+    for (int i = 1; i < argc; ++i) {
+        auto iter = g.identifier_map().find("machine:" + std::string{argv[i]});
+        if (iter == g.identifier_map().end()) {
+            std::cerr << "unknown node " << argv[i] << '\n';
+            return EXIT_FAILURE;
+        }
+        machines.push_back(iter->second);
+    }
+
+    auto dist = hop_distances(g, machines);
+    for (size_t i = 0; i < machines.size(); ++i) {
+        for (size_t j = i + 1; j < machines.size(); ++j) {
+            std::cout << argv[i + 1] << " - " << argv[j + 1] << ": " << dist[i * machines.size() + j] << " hops\n";
+        }
+    }
+
+    yloc::finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include <yloc/yloc.h>
+
+#include "interface_impl.h"
+
+using namespace yloc;
+
+ModuleHostname::ModuleHostname()
+{
+    // runs after the MPI module to reuse the hostnames of its process map
+    m_init_order = Module::init_order::THIRD;
+
+    const char *pattern = std::getenv("YLOC_HOSTNAME_PATTERN");
+    m_enabled = pattern != nullptr && *pattern != '\0';
+    if (m_enabled) {
+        m_pattern = std::string{pattern} == "supermuc" ? supermuc_hostname_pattern : pattern;
+    }
+}
+
+/* hostnames of all nodes, from the process map of the MPI module if it already gathered them */
+static std::vector<std::string> gather_hostnames(const Graph &g)
+{
+    const ProcessMap &map = g.process_map();
+    std::vector<std::string> hostnames{};
+    if (map.num_nodes() > 0) {
+        for (int node = 0; node < map.num_nodes(); ++node) {
+            hostnames.push_back(map.hostname(node));
+        }
+        return hostnames;
+    }
+
+    // like the MPI module: only node leaders exchange their hostname, the result is broadcast within each node
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm leader_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leader_comm);
+
+    std::vector<int> lengths{};
+    std::vector<char> buffer{};
+    int nnodes = 0;
+    if (leader_comm != MPI_COMM_NULL) {
+        char hostname[MPI_MAX_PROCESSOR_NAME] = {};
+        int hostname_length;
+        MPI_Get_processor_name(hostname, &hostname_length);
+
+        MPI_Comm_size(leader_comm, &nnodes);
+        lengths.resize(nnodes);
+        MPI_Allgather(&hostname_length, 1, MPI_INT, lengths.data(), 1, MPI_INT, leader_comm);
+        std::vector<int> displs(nnodes);
+        for (int node = 1; node < nnodes; ++node) {
+            displs[node] = displs[node - 1] + lengths[node - 1];
+        }
+        buffer.resize(nnodes > 0 ? displs.back() + lengths.back() : 0);
+        MPI_Allgatherv(hostname, hostname_length, MPI_CHAR, buffer.data(), lengths.data(), displs.data(), MPI_CHAR, leader_comm);
+        MPI_Comm_free(&leader_comm);
+    }
+
+    int sizes[2] = {nnodes, static_cast<int>(buffer.size())};
+    MPI_Bcast(sizes, 2, MPI_INT, 0, node_comm);
+    lengths.resize(sizes[0]);
+    buffer.resize(sizes[1]);
+    MPI_Bcast(lengths.data(), sizes[0], MPI_INT, 0, node_comm);
+    MPI_Bcast(buffer.data(), sizes[1], MPI_CHAR, 0, node_comm);
+    MPI_Comm_free(&node_comm);
+
+    size_t offset = 0;
+    for (int length : lengths) {
+        hostnames.emplace_back(buffer.data() + offset, length);
+        offset += length;
+    }
+    return hostnames;
+}
+
+yloc_status_t ModuleHostname::init_graph(Graph &g)
+{
+    int initialized;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        return YLOC_STATUS_INIT_ERROR;
+    }
+
+    std::regex pattern;
+    try {
+        pattern = std::regex{m_pattern, std::regex::optimize};
+    } catch (const std::regex_error &e) {
+        std::cerr << "invalid YLOC_HOSTNAME_PATTERN \"" << m_pattern << "\": " << e.what() << '\n';
+        return YLOC_STATUS_INVALID_ARGS;
+    }
+
+    yloc_status_t status = make_hostname_hierarchy(g, gather_hostnames(g), pattern);
+    if (status == YLOC_STATUS_NOT_FOUND) {
+        std::cerr << "no hostname matches YLOC_HOSTNAME_PATTERN \"" << m_pattern << "\"\n";
+    }
+    return status;
+}
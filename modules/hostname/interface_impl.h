@@ -0,0 +1,37 @@
+#pragma once
+
+#include <yloc/modules/module.h>
+
+#include <string>
+
+namespace yloc
+{
+    /**
+     * @brief Adds the system hierarchy (e.g. island, rack, chassis) encoded in the hostnames of all nodes.
+     *
+     * Enabled by the environment variable YLOC_HOSTNAME_PATTERN, a regular expression whose
+     * capture groups are the levels of the hierarchy (see make_hostname_hierarchy()), or
+     * "supermuc" for the naming convention of SuperMUC-NG.
+     */
+    class ModuleHostname : public Module
+    {
+    public:
+        ModuleHostname();
+
+        yloc_status_t init_graph(Graph &graph) override;
+
+        yloc_status_t export_graph(const Graph &graph, void **output) override
+        {
+            output = nullptr;
+            return YLOC_STATUS_NOT_SUPPORTED;
+        }
+
+        yloc_status_t update_graph(Graph &graph) override
+        {
+            return YLOC_STATUS_NOT_SUPPORTED;
+        }
+
+    private:
+        std::string m_pattern{};
+    };
+}
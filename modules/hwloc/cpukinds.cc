@@ -0,0 +1,51 @@
+#include <hwloc.h>
+
+#include <vector>
+
+#include <yloc/graph.h>
+
+#include "hwloc_adapter.h"
+#include "interface_impl.h"
+
+using namespace yloc;
+
+void ModuleHwloc::import_cpu_kinds(Graph &g)
+{
+    hwloc_topology_t t = m_topology;
+
+    int nr_kinds = hwloc_cpukinds_get_nr(t, 0);
+    if (nr_kinds <= 0) {
+        return;
+    }
+
+    // efficiency of each kind, kinds are only usable if hwloc could rank all of them
+    std::vector<int> efficiencies(nr_kinds);
+    int max_efficiency = -1;
+    for (int kind = 0; kind < nr_kinds; ++kind) {
+        if (hwloc_cpukinds_get_info(t, kind, nullptr, &efficiencies[kind], nullptr, nullptr, 0) != 0 || efficiencies[kind] < 0) {
+            return;
+        }
+        max_efficiency = std::max(max_efficiency, efficiencies[kind]);
+    }
+
+    std::vector<std::vector<vertex_descriptor_t>> cpu_kinds(max_efficiency + 1);
+    for (hwloc_obj_type_t type : {HWLOC_OBJ_CORE, HWLOC_OBJ_PU}) {
+        hwloc_obj_t obj = nullptr;
+        while ((obj = hwloc_get_next_obj_by_type(t, type, obj)) != nullptr) {
+            auto iter = m_vertices.find(obj);
+            int kind = hwloc_cpukinds_get_by_cpuset(t, obj->cpuset, 0);
+            if (iter == m_vertices.end() || kind < 0) {
+                continue;
+            }
+            HwlocAdapter *adapter = find_hwloc_adapter(g[iter->second], obj);
+            if (adapter == nullptr) {
+                continue;
+            }
+            adapter->set_efficiency_class(efficiencies[kind]);
+            if (type == HWLOC_OBJ_PU) {
+                cpu_kinds[efficiencies[kind]].push_back(iter->second);
+            }
+        }
+    }
+    g.set_cpu_kinds(std::move(cpu_kinds));
+}
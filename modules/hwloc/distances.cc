@@ -0,0 +1,82 @@
+#include <hwloc.h>
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <yloc/graph.h>
+
+#include "interface_impl.h"
+
+using namespace yloc;
+
+/* yloc name of a hwloc distance matrix, e.g. "numa_latency" for hwloc's "NUMALatency" */
+static std::string distance_table_name(hwloc_topology_t t, hwloc_distances_s *distances)
+{
+    if (distances->kind & HWLOC_DISTANCES_KIND_HETEROGENEOUS_TYPES) {
+        const char *name = hwloc_distances_get_name(t, distances);
+        return name != nullptr ? name : "distances";
+    }
+
+    std::string name;
+    if (distances->objs[0]->type == HWLOC_OBJ_NUMANODE) {
+        name = "numa";
+    } else {
+        name = hwloc_obj_type_string(distances->objs[0]->type);
+        for (auto &c : name) {
+            c = std::tolower(c);
+        }
+    }
+
+    if (distances->kind & HWLOC_DISTANCES_KIND_MEANS_BANDWIDTH) {
+        return name + "_bandwidth";
+    }
+    if (distances->kind & HWLOC_DISTANCES_KIND_MEANS_LATENCY) {
+        return name + "_latency";
+    }
+    return name + "_distance";
+}
+
+void ModuleHwloc::import_distances(Graph &g)
+{
+    hwloc_topology_t t = m_topology;
+
+    unsigned nr = 0;
+    if (hwloc_distances_get(t, &nr, nullptr, 0, 0) != 0 || nr == 0) {
+        return;
+    }
+    std::vector<hwloc_distances_s *> matrices(nr);
+    if (hwloc_distances_get(t, &nr, matrices.data(), 0, 0) != 0) {
+        return;
+    }
+
+    for (unsigned m = 0; m < nr; ++m) {
+        hwloc_distances_s *distances = matrices[m];
+
+        // hwloc may report objects that are not part of the graph (e.g. filtered types)
+        std::vector<vertex_descriptor_t> vertices(distances->nbobjs);
+        bool complete = distances->nbobjs > 0;
+        for (unsigned i = 0; i < distances->nbobjs && complete; ++i) {
+            auto iter = m_vertices.find(distances->objs[i]);
+            complete = iter != m_vertices.end();
+            if (complete) {
+                vertices[i] = iter->second;
+            }
+        }
+
+        if (complete) {
+            auto kind = (distances->kind & HWLOC_DISTANCES_KIND_MEANS_BANDWIDTH) ? DistanceTable::kind::BANDWIDTH
+                                                                                 : DistanceTable::kind::LATENCY;
+            DistanceTable table{kind, std::move(vertices)};
+            for (unsigned i = 0; i < distances->nbobjs; ++i) {
+                for (unsigned j = 0; j < distances->nbobjs; ++j) {
+                    table.set(i, j, distances->values[i * distances->nbobjs + j]);
+                }
+            }
+            m_distance_tables.push_back(distance_table_name(t, distances));
+            g.set_distance_table(m_distance_tables.back(), std::move(table));
+        }
+
+        hwloc_distances_release(t, distances);
+    }
+}
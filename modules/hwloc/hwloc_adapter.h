@@ -2,6 +2,7 @@
 
 #include <yloc/affinity.h>
 #include <yloc/modules/adapter.h>
+#include <yloc/vertex.h>
 
 #include <hwloc.h>
 
@@ -71,6 +72,26 @@ namespace yloc
             return {};
         }
 
+        std::optional<uint64_t> bandwidth() const override
+        {
+            return m_bandwidth;
+        }
+
+        std::optional<uint64_t> latency() const override
+        {
+            return m_latency;
+        }
+
+        std::optional<uint64_t> memory_tier() const override
+        {
+            return m_memory_tier;
+        }
+
+        std::optional<uint64_t> efficiency_class() const override
+        {
+            return m_efficiency_class;
+        }
+
         std::optional<AffinityMask> cpu_affinity_mask() const override
         {
             if (m_obj->cpuset == nullptr) {
@@ -83,7 +104,63 @@ namespace yloc
 
         obj_t native_obj() const { return m_obj; }
 
+        /**
+         * @brief Points the adapter to the object of a reloaded topology.
+         */
+        void set_native_obj(obj_t obj) { m_obj = obj; }
+
+        /**
+         * @brief Sets the memory attributes of a NUMA node as seen from its local cpus.
+         *
+         * @param bandwidth Bandwidth in bytes per second
+         * @param latency Latency in nanoseconds
+         * @param tier Memory tier, 0 for the fastest tier
+         */
+        void set_memory_attributes(std::optional<uint64_t> bandwidth, std::optional<uint64_t> latency, std::optional<uint64_t> tier)
+        {
+            m_bandwidth = bandwidth;
+            m_latency = latency;
+            m_memory_tier = tier;
+        }
+
+        /**
+         * @brief Sets the efficiency class of a core or PU from hwloc cpukinds.
+         */
+        void set_efficiency_class(std::optional<uint64_t> efficiency_class) { m_efficiency_class = efficiency_class; }
+
     private:
         obj_t m_obj;
+        std::optional<uint64_t> m_efficiency_class{};
+        std::optional<uint64_t> m_bandwidth{};
+        std::optional<uint64_t> m_latency{};
+        std::optional<uint64_t> m_memory_tier{};
     };
+
+    /**
+     * @brief Returns the hwloc adapter of obj attached to vertex v or nullptr if there is none.
+     */
+    static inline HwlocAdapter *find_hwloc_adapter(const Vertex &v, hwloc_obj_t obj)
+    {
+        for (Adapter *a : v.m_adapters) {
+            auto *hwloc_adapter = dynamic_cast<HwlocAdapter *>(a);
+            if (hwloc_adapter != nullptr && hwloc_adapter->native_obj() == obj) {
+                return hwloc_adapter;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns the hwloc adapter attached to vertex v or nullptr if there is none.
+     */
+    static inline HwlocAdapter *find_hwloc_adapter(const Vertex &v)
+    {
+        for (Adapter *a : v.m_adapters) {
+            auto *hwloc_adapter = dynamic_cast<HwlocAdapter *>(a);
+            if (hwloc_adapter != nullptr) {
+                return hwloc_adapter;
+            }
+        }
+        return nullptr;
+    }
 }
\ No newline at end of file
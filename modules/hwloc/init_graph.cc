@@ -1,11 +1,20 @@
 
+#include <algorithm>
 #include <hwloc.h>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <vector>
 #include <unistd.h> // gethostname
 
 #include <yloc/graph.h>
+#include <yloc/init.h>
 #include <yloc/modules/adapter.h>
 #include <yloc/modules/module.h>
+#include <yloc/sampling.h>
 #include <yloc/status.h>
 
 #include "hwloc_adapter.h"
@@ -20,6 +29,25 @@
 // hwloc hierarchy: machine -> numanode -> package -> cache -> core -> pu
 using namespace yloc;
 
+/* memory technology of a NUMA node from the hwloc subtype, e.g. "HBM", "MCDRAM", "DRAM", "NVM" or "CXL-DRAM" */
+static const yloc::Component *hwloc_numanode_2_yloc_type(hwloc_obj_t obj)
+{
+    if (obj->subtype == nullptr) {
+        return Memory::ptr();
+    }
+    std::string subtype{obj->subtype};
+    if (subtype == "HBM" || subtype == "MCDRAM") {
+        return HighBandwidthMemory::ptr();
+    } else if (subtype.find("CXL") != std::string::npos) {
+        return ExpansionMemory::ptr();
+    } else if (subtype == "NVM") {
+        return NonVolatileMemory::ptr();
+    } else if (subtype == "DRAM") {
+        return VolatileMemory::ptr();
+    }
+    return Memory::ptr();
+}
+
 static const yloc::Component *hwloc_2_yloc_type(hwloc_obj_t obj)
 {
     /** TODO: move that logic elsewhere and/or move type info to adapter */
@@ -75,8 +103,10 @@ static const yloc::Component *hwloc_2_yloc_type(hwloc_obj_t obj)
         else {
             return DataCache::ptr();
         }
+    } else if (!hwloc_compare_types(obj->type, HWLOC_OBJ_NUMANODE)) {
+        return hwloc_numanode_2_yloc_type(obj);
     } else if (hwloc_obj_type_is_memory(obj->type)) {
-        /* This currently includes NUMA nodes and Memory-side caches. */
+        /* This currently includes Memory-side caches. */
         return Memory::ptr();
     } else if (!hwloc_compare_types(obj->type, HWLOC_OBJ_OS_DEVICE) && obj->attr != NULL) {
         switch (obj->attr->osdev.type) {
@@ -104,8 +134,6 @@ static const yloc::Component *hwloc_2_yloc_type(hwloc_obj_t obj)
         return Node::ptr(); // yloc type not implemented yet
     } else if (!hwloc_compare_types(obj->type, HWLOC_OBJ_PACKAGE)) {
         return Misc::ptr(); // yloc type not implemented yet
-    } else if (!hwloc_compare_types(obj->type, HWLOC_OBJ_NUMANODE)) {
-        return Memory::ptr(); // yloc type not implemented yet
     } else if (!hwloc_compare_types(obj->type, HWLOC_OBJ_GROUP)) {
         return Misc::ptr(); // yloc type not implemented yet
     } else if (!hwloc_compare_types(obj->type, HWLOC_OBJ_MISC)) {
@@ -125,45 +153,153 @@ static const yloc::Component *hwloc_2_yloc_type(hwloc_obj_t obj)
     }
 }
 
+/**
+ * @brief Returns a key that identifies a hwloc object across topology reloads.
+ *
+ * Objects are identified by type and os index if it is unique in the machine (PUs, NUMA nodes,
+ * packages), by bus id (PCI devices) or by name (OS devices, Misc). Other objects (cores, dies,
+ * groups, caches) are identified within their package, by their os index or by their position
+ * among the objects of their level in the package. Cpusets are not part of keys, since they
+ * change when cpus are offlined or a cpuset is resized, while the object stays the same.
+ */
+static std::string hwloc_obj_key(hwloc_topology_t t, hwloc_obj_t obj)
+{
+    char type[64];
+    hwloc_obj_type_snprintf(type, sizeof(type), obj, 1);
+    std::string key{type};
+
+    bool unique_os_index = obj->type == HWLOC_OBJ_PU || obj->type == HWLOC_OBJ_NUMANODE || obj->type == HWLOC_OBJ_PACKAGE ||
+                           obj->type == HWLOC_OBJ_MACHINE;
+    if (obj->type == HWLOC_OBJ_PCI_DEVICE) {
+        return key + ":" + std::to_string(obj->attr->pcidev.domain) + ":" + std::to_string(obj->attr->pcidev.bus) + ":" +
+               std::to_string(obj->attr->pcidev.dev) + "." + std::to_string(obj->attr->pcidev.func);
+    } else if ((obj->type == HWLOC_OBJ_OS_DEVICE || obj->type == HWLOC_OBJ_MISC) && obj->name != nullptr) {
+        return key + ":" + obj->name;
+    } else if (unique_os_index && obj->os_index != HWLOC_UNKNOWN_INDEX) {
+        return key + ":" + std::to_string(obj->os_index);
+    }
+
+    hwloc_obj_t package = hwloc_get_ancestor_obj_by_type(t, HWLOC_OBJ_PACKAGE, obj);
+    key += ":" + (package != nullptr && package->os_index != HWLOC_UNKNOWN_INDEX ? std::to_string(package->os_index) : std::string{"-"});
+    if (obj->os_index != HWLOC_UNKNOWN_INDEX) {
+        return key + ":" + std::to_string(obj->os_index);
+    }
+    // cousins are in logical order, so those of the same package precede obj immediately
+    unsigned position = 0;
+    for (hwloc_obj_t cousin = obj->prev_cousin; cousin != nullptr && hwloc_get_ancestor_obj_by_type(t, HWLOC_OBJ_PACKAGE, cousin) == package;
+         cousin = cousin->prev_cousin) {
+        ++position;
+    }
+    return key + ":L" + std::to_string(position);
+}
+
+/* hwloc parent of a vertex, i.e. the target of its PARENT edge that is managed by the hwloc module */
+static std::optional<vertex_descriptor_t> hwloc_parent(const Graph &g, vertex_descriptor_t vd)
+{
+    for (auto e : boost::make_iterator_range(boost::out_edges(vd, g))) {
+        if (g[e].type == edge_type::PARENT && find_hwloc_adapter(g[boost::target(e, g)]) != nullptr) {
+            return boost::target(e, g);
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Takes a detached vertex for a new object with key and type.
+ *
+ * An object that reappears (e.g. an onlined cpu) gets its former vertex back. Other objects get
+ * a detached vertex of the same type that is not used otherwise, so that repeated refreshes do not
+ * grow the graph. PCI devices only get their former vertex, since others lack their identifier.
+ */
+std::optional<vertex_descriptor_t> ModuleHwloc::reuse_detached_vertex(const Graph &g, const std::string &key, const Component *type)
+{
+    auto iter = m_detached.find(key);
+    if (iter == m_detached.end() && !type->is_a<PCIDevice>()) {
+        iter = std::find_if(m_detached.begin(), m_detached.end(), [&](const auto &detached) {
+            return detached.second.unused && detached.second.type == type && g[detached.second.vd].m_adapters.empty();
+        });
+    }
+    if (iter == m_detached.end()) {
+        return {};
+    }
+    vertex_descriptor_t vd = iter->second.vd;
+    m_detached.erase(iter);
+    return vd;
+}
+
 /**
  * @brief Build boost graph from hwloc (sub)tree.
  *
+ * Objects that are already part of the graph (same key in m_keys) keep their vertex, the adapter
+ * is pointed to the new hwloc object (so masks and attributes are updated in place) and the
+ * vertex is moved if its parent changed. New objects preferably take detached vertices.
+ *
  * @param g
- * @param t
  * @param vd
  * @param obj
+ * @param keys Keys of all objects of the (new) topology
  */
-static void make_hwloc_graph(Graph &g, hwloc_topology_t t, vertex_descriptor_t vd, hwloc_obj_t obj)
+void ModuleHwloc::make_hwloc_graph(Graph &g, vertex_descriptor_t vd, hwloc_obj *obj, std::unordered_map<std::string, vertex_descriptor_t> &keys)
 {
+    hwloc_topology_t t = m_topology;
+
     // for all children of obj: add_adapter new vertex to graph and set edges
     hwloc_obj_t child = hwloc_get_next_child(t, obj, NULL);
     while (child) {
-        auto *adapter = new HwlocAdapter{child};
+        std::string key = hwloc_obj_key(t, child);
+        // keys are unique within a tree, duplicates (in traversal order) are numbered
+        if (keys.count(key) != 0) {
+            int n = 1;
+            while (keys.count(key + "#" + std::to_string(n)) != 0) {
+                ++n;
+            }
+            key += "#" + std::to_string(n);
+        }
         vertex_descriptor_t child_vd;
 
-        if (hwloc_2_yloc_type(child)->is_a<PCIDevice>()) {
-            std::string id = "bdfid:" + std::to_string(adapter->bdfid().value());
-            child_vd = g.add_vertex(id);
-            // std::cout << "hwloc pcidevice " << id << " vd: " << child_vd << "\n";
+        auto known = m_keys.find(key);
+        if (known != m_keys.end()) {
+            child_vd = known->second;
+            find_hwloc_adapter(g[child_vd])->set_native_obj(child);
+
+            auto parent_vd = hwloc_parent(g, child_vd);
+            if (!parent_vd.has_value() || parent_vd.value() != vd) {
+                if (parent_vd.has_value()) {
+                    g.remove_relation(parent_vd.value(), child_vd);
+                }
+                g.add_relation(vd, child_vd);
+            }
         } else {
-            child_vd = g.add_vertex();
-        }
+            auto *adapter = new HwlocAdapter{child};
+            const Component *type = hwloc_2_yloc_type(child);
 
-        if (g[child_vd].m_description.empty()) {
-            g[child_vd].m_description = adapter->to_string();
-        }
+            if (auto reused = reuse_detached_vertex(g, key, type)) {
+                child_vd = reused.value();
+            } else if (type->is_a<PCIDevice>()) {
+                std::string id = "bdfid:" + std::to_string(adapter->bdfid().value());
+                child_vd = g.add_vertex(id);
+                // std::cout << "hwloc pcidevice " << id << " vd: " << child_vd << "\n";
+            } else {
+                child_vd = g.add_vertex();
+            }
 
-        g[child_vd].add_adapter(adapter);
-        if (g[child_vd].type == UnknownComponentType::ptr()) { // has no component type yet
-            g[child_vd].type = hwloc_2_yloc_type(child);
-        } else {
-            // sanity check /** TODO: implement is_a for runtime objects */
-            // assert(g[child_vd].type == hwloc_2_yloc_type(obj));
+            if (g[child_vd].m_description.empty()) {
+                g[child_vd].m_description = adapter->to_string();
+            }
+
+            g[child_vd].add_adapter(adapter);
+            if (g[child_vd].type == UnknownComponentType::ptr()) { // has no component type yet
+                g[child_vd].type = type;
+            } else {
+                // sanity check /** TODO: implement is_a for runtime objects */
+                // assert(g[child_vd].type == hwloc_2_yloc_type(obj));
+            }
+            g.add_relation(vd, child_vd);
         }
-        auto ret = boost::add_edge(vd, child_vd, Edge{edge_type::CHILD}, g);
-        ret = boost::add_edge(child_vd, vd, Edge{edge_type::PARENT}, g);
 
-        make_hwloc_graph(g, t, child_vd, child);
+        keys[key] = child_vd;
+        m_vertices[child] = child_vd;
+        make_hwloc_graph(g, child_vd, child, keys);
         child = hwloc_get_next_child(t, obj, child);
     }
 }
@@ -199,9 +335,64 @@ static void set_hwloc_options(hwloc_topology_t &t)
     // hwloc_topology_set_xml(t, file)
 }
 
+/**
+ * @brief Restricts the topology to the resources available to this process.
+ *
+ * Removes the cpus and memory nodes that are disallowed by cgroups or cpusets, which are the same
+ * for all processes of a job on a node. If bound, this additionally removes cpus and memory nodes
+ * the process is not bound to (e.g. by Slurm --cpu-bind or taskset), which usually differ between
+ * the processes. Binding is only queried if the topology describes the running system.
+ * I/O and Misc objects of removed parents are moved up instead of being removed.
+ */
+static int restrict_topology(hwloc_topology_t t, bool bound)
+{
+    hwloc_bitmap_t cpuset = hwloc_bitmap_dup(hwloc_topology_get_allowed_cpuset(t));
+    hwloc_bitmap_t nodeset = hwloc_bitmap_dup(hwloc_topology_get_allowed_nodeset(t));
+
+    if (bound && hwloc_topology_is_thissystem(t)) {
+        hwloc_bitmap_t binding = hwloc_bitmap_alloc();
+        if (hwloc_get_cpubind(t, binding, HWLOC_CPUBIND_PROCESS) == 0) {
+            hwloc_bitmap_and(cpuset, cpuset, binding);
+        }
+        hwloc_membind_policy_t policy;
+        if (hwloc_get_membind(t, binding, &policy, HWLOC_MEMBIND_PROCESS | HWLOC_MEMBIND_BYNODESET) == 0) {
+            hwloc_bitmap_and(nodeset, nodeset, binding);
+        }
+        hwloc_bitmap_free(binding);
+    }
+
+    int ret = -1;
+    if (!hwloc_bitmap_iszero(cpuset) && !hwloc_bitmap_iszero(nodeset)) {
+        // by default only objects without cpus and memory are removed, so cpu-less memory survives the cpuset step
+        const unsigned long flags = HWLOC_RESTRICT_FLAG_ADAPT_IO | HWLOC_RESTRICT_FLAG_ADAPT_MISC;
+        ret = hwloc_topology_restrict(t, cpuset, flags);
+        if (ret == 0) {
+            ret = hwloc_topology_restrict(t, nodeset, flags | HWLOC_RESTRICT_FLAG_BYNODESET);
+        }
+    }
+
+    hwloc_bitmap_free(cpuset);
+    hwloc_bitmap_free(nodeset);
+    return ret;
+}
+
+/* initializes and loads a topology according to the yloc init flags */
+static int load_topology(hwloc_topology_t &t)
+{
+    hwloc_topology_init(&t);
+    set_hwloc_options(t);
+    int ret = hwloc_topology_load(t); // actual detection
+    if (ret == 0 && (init_flags() & (YLOC_RESTRICT | YLOC_BOUND))) {
+        ret = restrict_topology(t, init_flags() & YLOC_BOUND);
+    }
+    return ret;
+}
+
 ModuleHwloc::~ModuleHwloc()
 {
-    hwloc_topology_destroy(m_topology);
+    if (m_topology != nullptr) {
+        hwloc_topology_destroy(m_topology);
+    }
 }
 
 yloc_status_t ModuleHwloc::init_graph(Graph &g)
@@ -209,9 +400,9 @@ yloc_status_t ModuleHwloc::init_graph(Graph &g)
     check_hwloc_api_version();
 
     hwloc_topology_t &t = m_topology;
-    hwloc_topology_init(&t);
-    set_hwloc_options(t);
-    hwloc_topology_load(t); // actual detection
+    if (load_topology(t) != 0) {
+        return YLOC_STATUS_INIT_ERROR;
+    }
 
     hwloc_obj_t root = hwloc_get_root_obj(t);
     assert(root->type == HWLOC_OBJ_MACHINE);
@@ -231,6 +422,113 @@ yloc_status_t ModuleHwloc::init_graph(Graph &g)
         // assert(g[root_vd].type == hwloc_2_yloc_type(root));
     }
 
-    make_hwloc_graph(g, t, root_vd, root);
+    m_root_vertex = root_vd;
+    m_vertices[root] = root_vd;
+    // m_keys is only consulted on updates, a fresh topology gets a vertex per object
+    m_keys.clear();
+    m_detached.clear();
+    std::unordered_map<std::string, vertex_descriptor_t> keys{};
+    make_hwloc_graph(g, root_vd, root, keys);
+    m_keys = std::move(keys);
+
+    import_distances(g);
+    import_memory_attributes(g);
+    import_cpu_kinds(g);
     return YLOC_STATUS_SUCCESS;
 }
+
+yloc_status_t ModuleHwloc::update_graph(Graph &g)
+{
+    if (m_topology == nullptr) { // graph was loaded from a shared snapshot
+        return YLOC_STATUS_NOT_SUPPORTED;
+    }
+    hwloc_topology_t old_topology = m_topology;
+
+    hwloc_topology_t &t = m_topology;
+    if (load_topology(t) != 0) {
+        hwloc_topology_destroy(t);
+        m_topology = old_topology;
+        return YLOC_STATUS_INIT_ERROR;
+    }
+
+    std::lock_guard<std::shared_mutex> structure_lock{structure_mutex()};
+    hwloc_obj_t root = hwloc_get_root_obj(t);
+    find_hwloc_adapter(g[m_root_vertex])->set_native_obj(root);
+
+    m_vertices.clear();
+    m_vertices[root] = m_root_vertex;
+    std::unordered_map<std::string, vertex_descriptor_t> keys{};
+    make_hwloc_graph(g, m_root_vertex, root, keys);
+
+    // objects that disappeared (e.g. offlined cpus) keep their vertex descriptor but are detached
+    std::vector<std::pair<std::string, vertex_descriptor_t>> removed{};
+    for (auto &[key, vd] : m_keys) {
+        if (keys.find(key) == keys.end()) {
+            removed.emplace_back(key, vd);
+        }
+    }
+    detach_vertices(g, removed);
+    m_keys = std::move(keys);
+
+    hwloc_topology_destroy(old_topology);
+
+    for (const auto &name : m_distance_tables) {
+        g.remove_distance_table(name);
+    }
+    m_distance_tables.clear();
+    g.set_cpu_kinds({});
+    import_distances(g);
+    import_memory_attributes(g);
+    import_cpu_kinds(g);
+    return YLOC_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Detaches vertices of removed hwloc objects from the graph.
+ *
+ * Vertices keep their descriptor but lose their hwloc adapter and all edges, they are kept by key
+ * for reuse. Vertices of other modules below them (e.g. MPI processes) are moved to the closest
+ * remaining hwloc ancestor.
+ */
+void ModuleHwloc::detach_vertices(Graph &g, const std::vector<std::pair<std::string, vertex_descriptor_t>> &removed)
+{
+    std::unordered_set<vertex_descriptor_t> removed_set{};
+    for (const auto &detached : removed) {
+        removed_set.insert(detached.second);
+    }
+
+    // first collect the new parents of foreign children while the old edges are still intact
+    std::vector<std::pair<vertex_descriptor_t, vertex_descriptor_t>> moved{};
+    for (const auto &[key, vd] : removed) {
+        vertex_descriptor_t ancestor = vd;
+        while (removed_set.count(ancestor) != 0) {
+            ancestor = hwloc_parent(g, ancestor).value_or(m_root_vertex);
+        }
+        for (auto e : boost::make_iterator_range(boost::out_edges(vd, g))) {
+            vertex_descriptor_t target = boost::target(e, g);
+            if (g[e].type == edge_type::CHILD && find_hwloc_adapter(g[target]) == nullptr) {
+                moved.emplace_back(ancestor, target);
+            }
+        }
+    }
+
+    std::unordered_set<vertex_descriptor_t> identified{};
+    for (const auto &[id, vd] : g.identifier_map()) {
+        identified.insert(vd);
+    }
+    for (const auto &[key, vd] : removed) {
+        HwlocAdapter *adapter = find_hwloc_adapter(g[vd]);
+        m_detached[key] = {vd, g[vd].type, g[vd].m_adapters.size() == 1 && identified.count(vd) == 0};
+        g[vd].remove_adapter(adapter);
+        delete adapter;
+        g.clear_vertex(vd);
+        if (g[vd].m_adapters.empty()) {
+            g[vd].type = UnknownComponentType::ptr();
+            g[vd].m_description.clear();
+        }
+    }
+
+    for (auto &[parent, child] : moved) {
+        g.add_relation(parent, child);
+    }
+}
@@ -1,14 +1,27 @@
 #pragma once
 
+#include <yloc/graph.h>
 #include <yloc/modules/module.h>
 
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 struct hwloc_topology; // fwd decl
+struct hwloc_obj;      // fwd decl
 
 namespace yloc
 {
     class ModuleHwloc : public Module
     {
     public:
+        ModuleHwloc()
+        {
+            m_shareable = true;
+            m_structural = true;
+        }
+
         yloc_status_t init_graph(Graph &graph) override;
 
         yloc_status_t export_graph(const Graph &graph, void **output) override
@@ -17,14 +30,62 @@ namespace yloc
             return YLOC_STATUS_NOT_YET_IMPLEMENTED;
         }
 
-        yloc_status_t update_graph(Graph &graph) override
-        {
-            return YLOC_STATUS_NOT_YET_IMPLEMENTED;
-        };
+        /**
+         * @brief Reloads the hwloc topology and applies the differences to the graph.
+         *
+         * Vertices of objects that still exist keep their descriptors, removed objects are
+         * detached from the graph and new objects are added, preferably on detached vertices.
+         * Sampling is paused meanwhile.
+         */
+        yloc_status_t update_graph(Graph &graph) override;
 
         ~ModuleHwloc();
 
     private:
-        hwloc_topology *m_topology;
+        void make_hwloc_graph(Graph &graph, vertex_descriptor_t vd, hwloc_obj *obj, std::unordered_map<std::string, vertex_descriptor_t> &keys);
+
+        std::optional<vertex_descriptor_t> reuse_detached_vertex(const Graph &graph, const std::string &key, const Component *type);
+
+        void detach_vertices(Graph &graph, const std::vector<std::pair<std::string, vertex_descriptor_t>> &removed);
+
+        /**
+         * @brief Imports hwloc distance matrices (e.g. NUMA latencies) as distance tables of the graph.
+         */
+        void import_distances(Graph &graph);
+
+        /**
+         * @brief Imports hwloc memory attributes (bandwidth, latency) of NUMA nodes and assigns memory tiers.
+         *
+         * The tiers are the MemoryTier infos of hwloc (>= 2.10) if it provides a valid one for every
+         * NUMA node, otherwise all tiers are derived from the technology, bandwidth and latency.
+         */
+        void import_memory_attributes(Graph &graph);
+
+        /**
+         * @brief Imports hwloc cpukinds as efficiency classes of cores and PUs and indexes the PUs by class.
+         */
+        void import_cpu_kinds(Graph &graph);
+
+        hwloc_topology *m_topology{nullptr};
+
+        /** graph vertices of hwloc objects */
+        std::unordered_map<hwloc_obj *, vertex_descriptor_t> m_vertices{};
+
+        /** graph vertices by object key, stable across topology reloads */
+        std::unordered_map<std::string, vertex_descriptor_t> m_keys{};
+
+        struct detached_vertex {
+            vertex_descriptor_t vd;
+            const Component *type; // type of the former object
+            bool unused;           // no adapters of other modules and no identifier
+        };
+
+        /** detached vertices by the key of their former object */
+        std::unordered_map<std::string, detached_vertex> m_detached{};
+
+        vertex_descriptor_t m_root_vertex{};
+
+        /** names of the distance tables imported from hwloc */
+        std::vector<std::string> m_distance_tables{};
     };
 }
\ No newline at end of file
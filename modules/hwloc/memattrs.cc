@@ -0,0 +1,191 @@
+#include <hwloc.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <yloc/graph.h>
+
+#include "hwloc_adapter.h"
+#include "interface_impl.h"
+
+using namespace yloc;
+
+/* hwloc reports bandwidths in MiB/s, yloc in bytes per second */
+static constexpr uint64_t mib = 1024 * 1024;
+
+/* value of a memory attribute for accesses to target from the cpus in initiator */
+static std::optional<uint64_t> memattr_value(hwloc_topology_t t, hwloc_memattr_id_t attribute, hwloc_obj_t target, hwloc_cpuset_t initiator)
+{
+    if (initiator == nullptr || hwloc_bitmap_iszero(initiator)) {
+        return {};
+    }
+    hwloc_location location;
+    location.type = HWLOC_LOCATION_TYPE_CPUSET;
+    location.location.cpuset = initiator;
+    hwloc_uint64_t value;
+    if (hwloc_memattr_get_value(t, attribute, target, &location, 0, &value) != 0) {
+        return {};
+    }
+    return value;
+}
+
+/* value of a memory attribute as seen from the local cpus of a NUMA node, or from the best initiator for cpu-less nodes */
+static std::optional<uint64_t> memattr_local_value(hwloc_topology_t t, hwloc_memattr_id_t attribute, hwloc_obj_t target)
+{
+    auto value = memattr_value(t, attribute, target, target->cpuset);
+    if (value.has_value()) {
+        return value;
+    }
+    hwloc_location initiator;
+    hwloc_uint64_t best;
+    if (hwloc_memattr_get_best_initiator(t, attribute, target, 0, &initiator, &best) != 0) {
+        return {};
+    }
+    return best;
+}
+
+/* coarse ordering of memory technologies if no bandwidth information is available */
+static int technology_rank(const Component *type)
+{
+    if (type->is_a<HighBandwidthMemory>()) {
+        return 0;
+    } else if (type->is_a<ExpansionMemory>()) {
+        return 2;
+    } else if (type->is_a<NonVolatileMemory>()) {
+        return 3;
+    }
+    return 1;
+}
+
+struct numanode_info {
+    hwloc_obj_t obj;
+    vertex_descriptor_t vd;
+    HwlocAdapter *adapter;
+    std::optional<uint64_t> bandwidth;
+    std::optional<uint64_t> latency;
+};
+
+/**
+ * @brief Assigns memory tiers to NUMA nodes, tier 0 being the fastest memory.
+ *
+ * Nodes are ordered by technology, local bandwidth and latency. A new tier starts whenever
+ * the technology (see technology_rank()) changes or the bandwidth differs by more than 10% from the
+ * first node of the tier.
+ */
+static std::vector<uint64_t> memory_tiers(const Graph &g, std::vector<numanode_info> &nodes)
+{
+    std::vector<size_t> order(nodes.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        int rank_a = technology_rank(g[nodes[a].vd].type);
+        int rank_b = technology_rank(g[nodes[b].vd].type);
+        if (rank_a != rank_b) {
+            return rank_a < rank_b;
+        }
+        uint64_t bw_a = nodes[a].bandwidth.value_or(0);
+        uint64_t bw_b = nodes[b].bandwidth.value_or(0);
+        if (bw_a != bw_b) {
+            return bw_a > bw_b;
+        }
+        return nodes[a].latency.value_or(UINT64_MAX) < nodes[b].latency.value_or(UINT64_MAX);
+    });
+
+    std::vector<uint64_t> tiers(nodes.size());
+    uint64_t tier = 0;
+    size_t first = order.empty() ? 0 : order[0];
+    for (size_t i : order) {
+        bool same_technology = technology_rank(g[nodes[i].vd].type) == technology_rank(g[nodes[first].vd].type);
+        uint64_t bw_first = nodes[first].bandwidth.value_or(0);
+        uint64_t bw = nodes[i].bandwidth.value_or(0);
+        bool same_bandwidth = 10 * (bw_first - bw) <= bw_first; // nodes of a technology are sorted by decreasing bandwidth
+        if (!same_technology || !same_bandwidth) {
+            tier++;
+            first = i;
+        }
+        tiers[i] = tier;
+    }
+    return tiers;
+}
+
+void ModuleHwloc::import_memory_attributes(Graph &g)
+{
+    hwloc_topology_t t = m_topology;
+
+    std::vector<numanode_info> nodes{};
+    hwloc_obj_t obj = nullptr;
+    while ((obj = hwloc_get_next_obj_by_type(t, HWLOC_OBJ_NUMANODE, obj)) != nullptr) {
+        auto iter = m_vertices.find(obj);
+        if (iter == m_vertices.end()) {
+            continue;
+        }
+        HwlocAdapter *adapter = find_hwloc_adapter(g[iter->second], obj);
+        if (adapter == nullptr) {
+            continue;
+        }
+        auto bandwidth = memattr_local_value(t, HWLOC_MEMATTR_ID_BANDWIDTH, obj);
+        if (bandwidth.has_value()) {
+            bandwidth = bandwidth.value() * mib;
+        }
+        nodes.push_back({obj, iter->second, adapter, bandwidth, memattr_local_value(t, HWLOC_MEMATTR_ID_LATENCY, obj)});
+    }
+
+    if (nodes.empty()) {
+        return;
+    }
+
+    // hwloc >= 2.10 already ranks memory tiers, otherwise derive them from the attributes;
+    // the tiers of all nodes come from the same source, so that they are comparable
+    std::vector<uint64_t> tiers(nodes.size());
+    bool hwloc_tiers = true;
+    for (size_t i = 0; i < nodes.size() && hwloc_tiers; ++i) {
+        const char *hwloc_tier = hwloc_obj_get_info_by_name(nodes[i].obj, "MemoryTier");
+        char *end = nullptr;
+        if (hwloc_tier != nullptr && *hwloc_tier != '\0') {
+            tiers[i] = std::strtoull(hwloc_tier, &end, 10);
+        }
+        hwloc_tiers = end != nullptr && *end == '\0';
+    }
+    if (!hwloc_tiers) {
+        tiers = memory_tiers(g, nodes);
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].adapter->set_memory_attributes(nodes[i].bandwidth, nodes[i].latency, tiers[i]);
+    }
+
+    // initiator/target matrices: row i holds the values for accesses from the local cpus of node i
+    std::vector<vertex_descriptor_t> vertices{};
+    for (auto &node : nodes) {
+        vertices.push_back(node.vd);
+    }
+    DistanceTable bandwidth_table{DistanceTable::kind::BANDWIDTH, vertices};
+    DistanceTable latency_table{DistanceTable::kind::LATENCY, vertices};
+    bool has_bandwidth = false;
+    bool has_latency = false;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (size_t j = 0; j < nodes.size(); ++j) {
+            auto bandwidth = memattr_value(t, HWLOC_MEMATTR_ID_BANDWIDTH, nodes[j].obj, nodes[i].obj->cpuset);
+            if (bandwidth.has_value()) {
+                bandwidth_table.set(i, j, bandwidth.value() * mib);
+                has_bandwidth = true;
+            }
+            auto latency = memattr_value(t, HWLOC_MEMATTR_ID_LATENCY, nodes[j].obj, nodes[i].obj->cpuset);
+            if (latency.has_value()) {
+                latency_table.set(i, j, latency.value());
+                has_latency = true;
+            }
+        }
+    }
+    if (has_bandwidth) {
+        m_distance_tables.push_back("memory_bandwidth");
+        g.set_distance_table("memory_bandwidth", std::move(bandwidth_table));
+    }
+    if (has_latency) {
+        m_distance_tables.push_back("memory_latency");
+        g.set_distance_table("memory_latency", std::move(latency_table));
+    }
+}
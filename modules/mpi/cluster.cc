@@ -0,0 +1,191 @@
+#include "interface_impl.h"
+#include <yloc/node_template.h>
+#include <yloc/snapshot.h>
+#include <yloc/yloc.h>
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace yloc;
+
+/* the local machine vertex and all vertices below it except MPI processes */
+static std::vector<vertex_descriptor_t> machine_vertices(const Graph &g)
+{
+    std::vector<vertex_descriptor_t> vertices{g.get_root_vertex()};
+    std::vector<bool> visited(boost::num_vertices(g), false);
+    visited[g.get_root_vertex()] = true;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        for (auto e : boost::make_iterator_range(boost::out_edges(vertices[i], g))) {
+            vertex_descriptor_t child = boost::target(e, g);
+            if (g[e].type == edge_type::CHILD && !visited[child] && !g[child].type->is_a<MPIProcess>()) {
+                visited[child] = true;
+                vertices.push_back(child);
+            }
+        }
+    }
+    return vertices;
+}
+
+static constexpr uint32_t s_no_location = std::numeric_limits<uint32_t>::max();
+
+/* index of the parent of every process on the local node among vertices, in the order of the local ranks */
+static std::vector<uint32_t> process_locations(Graph &g, const std::vector<vertex_descriptor_t> &vertices)
+{
+    std::unordered_map<vertex_descriptor_t, uint32_t> index{};
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        index[vertices[i]] = static_cast<uint32_t>(i);
+    }
+    ProcessMap &map = g.process_map();
+    std::vector<uint32_t> locations{};
+    for (const auto &run : map.runs()) {
+        for (int i = 0; run.node == map.local_node() && i < run.count; ++i) {
+            auto vd = map.vertex(g, run.first_rank + i);
+            auto parent = vd.has_value() ? g.parent(vd.value()) : std::nullopt;
+            auto iter = parent.has_value() ? index.find(parent.value()) : index.end();
+            locations.push_back(iter != index.end() ? iter->second : s_no_location);
+        }
+    }
+    return locations;
+}
+
+void yloc::attach_process_to_instance(Graph &g, vertex_descriptor_t process_vd, int rank)
+{
+    auto machine_vd = g.parent(process_vd);
+    TemplateInstance *instance = machine_vd.has_value() ? g.template_instance(machine_vd.value()) : nullptr;
+    auto location = instance != nullptr ? instance->find("mpi_rank:" + std::to_string(rank)) : std::nullopt;
+    if (location.has_value()) {
+        instance->attach(process_vd, location.value());
+    }
+}
+
+/**
+ * Node leaders allgather the snapshot hashes of their machines and send the machine snapshot only
+ * if no leader with a lower rank has the same hash and size. Hashes cover the snapshot bytes, so
+ * machines only share a template if they are identical including tables and attributes, and the
+ * vertex indices of a snapshot are those of the template. A single allgatherv then distributes
+ * the unique snapshots, which are broadcast within each node. Leaders are numbered like the nodes
+ * of the process map. Every unique snapshot becomes one node template, remote machines only
+ * reference the template of their kind, so the graph grows with the number of SKUs.
+ *
+ * The location of every process (the index of its parent in the snapshot of its node, 4 bytes per
+ * rank) is exchanged as well. It becomes the identifier "mpi_rank:<rank>" of the instance, and
+ * remote process vertices are attached there, so that hop distances and the rank mapping see
+ * the cores of remote processes without expanding their machines.
+ */
+void ModuleMPI::assemble_cluster_graph(Graph &g, MPI_Comm node_comm)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+
+    MPI_Comm leader_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leader_comm);
+
+    const ProcessMap &map = g.process_map();
+    std::vector<char> snapshots{};
+    int nnodes = map.num_nodes();
+    std::vector<uint64_t> hashes(nnodes);
+    std::vector<int> sizes(nnodes), displs(nnodes);
+    std::vector<uint32_t> locations(map.size());
+    std::vector<int> node_sizes(nnodes, 0), node_displs(nnodes);
+    for (const auto &run : map.runs()) {
+        node_sizes[run.node] += run.count;
+    }
+    for (int node = 0, total = 0; node < nnodes; ++node) {
+        node_displs[node] = total;
+        total += node_sizes[node];
+    }
+
+    if (leader_comm != MPI_COMM_NULL) {
+        std::vector<vertex_descriptor_t> vertices = machine_vertices(g);
+        std::vector<char> snapshot = make_snapshot(g, vertices);
+        uint64_t hash = snapshot_hash(snapshot);
+        int size = static_cast<int>(snapshot.size());
+        MPI_Allgather(&hash, 1, MPI_UINT64_T, hashes.data(), 1, MPI_UINT64_T, leader_comm);
+        MPI_Allgather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, leader_comm);
+
+        // only the first node of every kind of machine sends its snapshot
+        std::vector<int> counts(nnodes, 0);
+        int total = 0;
+        for (int node = 0; node < nnodes; ++node) {
+            bool first = true;
+            for (int other = 0; other < node && first; ++other) {
+                first = hashes[other] != hashes[node] || sizes[other] != sizes[node];
+            }
+            displs[node] = total;
+            counts[node] = first ? sizes[node] : 0;
+            total += counts[node];
+        }
+        snapshots.resize(total);
+        MPI_Allgatherv(snapshot.data(), counts[map.local_node()], MPI_CHAR, snapshots.data(), counts.data(), displs.data(), MPI_CHAR, leader_comm);
+
+        std::vector<uint32_t> local_locations = process_locations(g, vertices);
+        MPI_Allgatherv(local_locations.data(), node_sizes[map.local_node()], MPI_UINT32_T, locations.data(), node_sizes.data(), node_displs.data(), MPI_UINT32_T,
+                       leader_comm);
+        MPI_Comm_free(&leader_comm);
+    }
+
+    MPI_Bcast(hashes.data(), nnodes, MPI_UINT64_T, 0, node_comm);
+    MPI_Bcast(sizes.data(), nnodes, MPI_INT, 0, node_comm);
+    MPI_Bcast(displs.data(), nnodes, MPI_INT, 0, node_comm);
+    uint64_t total = snapshots.size();
+    MPI_Bcast(&total, 1, MPI_UINT64_T, 0, node_comm);
+    snapshots.resize(total);
+    MPI_Bcast(snapshots.data(), static_cast<int>(total), MPI_CHAR, 0, node_comm);
+    MPI_Bcast(locations.data(), map.size(), MPI_UINT32_T, 0, node_comm);
+
+    std::unordered_map<int, std::shared_ptr<const NodeTemplate>> templates{};
+    for (int node = 0; node < nnodes; ++node) {
+        if (node == map.local_node()) {
+            continue;
+        }
+        // first node with the same kind of machine
+        int source = node;
+        for (int other = 0; other < node; ++other) {
+            if (hashes[other] == hashes[node] && sizes[other] == sizes[node]) {
+                source = other;
+                break;
+            }
+        }
+
+        auto &node_template = templates[source];
+        if (!node_template) {
+            const char *data = snapshots.data() + displs[source];
+            node_template = make_node_template(std::vector<char>(data, data + sizes[source]));
+            if (!node_template) {
+                continue;
+            }
+        }
+
+        const std::string &hostname = map.hostname(node);
+        vertex_descriptor_t machine_vd = g.add_vertex("machine:" + hostname);
+        if (g[machine_vd].m_description.empty()) {
+            g[machine_vd].m_description = hostname;
+        }
+        TemplateInstance *instance = add_template_instance(g, machine_vd, node_template);
+
+        uint32_t num_vertices = static_cast<uint32_t>(boost::num_vertices(instance->graph()));
+        for (const auto &run : map.runs()) {
+            for (int i = 0; run.node == node && i < run.count; ++i) {
+                uint32_t location = locations[node_displs[node] + run.first_local_index + i];
+                if (location < num_vertices) {
+                    instance->set_identifier("mpi_rank:" + std::to_string(run.first_rank + i), location);
+                }
+            }
+        }
+        // processes that are already part of the graph, others are attached when they are materialized
+        for (auto process_vd : g.children(machine_vd)) {
+            auto process_rank = g[process_vd].get<uint64_t>("mpi_rank");
+            if (g[process_vd].type->is_a<MPIProcess>() && process_rank.has_value()) {
+                attach_process_to_instance(g, process_vd, static_cast<int>(process_rank.value()));
+            }
+        }
+    }
+}
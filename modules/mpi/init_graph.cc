@@ -5,7 +5,9 @@
 
 #include <mpi.h>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <cassert>
 #include <cstring>
@@ -17,42 +19,176 @@
 
 using namespace yloc;
 
-static void make_mpi_graph(Graph &g, const char *hostname)
+/* exclusive prefix sum, returns the total */
+static int displacements(const std::vector<int> &counts, std::vector<int> &displs)
 {
-    int nbproc;
-    MPI_Comm_size(MPI_COMM_WORLD, &nbproc);
+    displs.resize(counts.size());
+    int total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        displs[i] = total;
+        total += counts[i];
+    }
+    return total;
+}
+
+/* runs of consecutive ranks in the (sorted) world ranks of a node */
+static std::vector<ProcessMap::run> local_runs(const std::vector<int> &local_ranks, int node)
+{
+    std::vector<ProcessMap::run> runs{};
+    for (int i = 0; i < static_cast<int>(local_ranks.size()); ++i) {
+        if (runs.empty() || local_ranks[i] != runs.back().first_rank + runs.back().count) {
+            runs.push_back({local_ranks[i], 0, node, i});
+        }
+        runs.back().count++;
+    }
+    return runs;
+}
+
+/**
+ * @brief Gathers the placement of all ranks in two levels.
+ *
+ * Node leaders exchange the rank runs and hostnames of their node, the result is broadcast within
+ * each node. Nodes are numbered by the rank of their leader among all leaders. Every rank receives
+ * O(#runs + #nodes * hostname length) bytes, i.e. O(#nodes) for block placements.
+ *
+ * @param local_ranks World ranks of the processes on the local node in ascending order
+ */
+static ProcessMap gather_process_map(MPI_Comm node_comm, const std::vector<int> &local_ranks, const char *hostname)
+{
+    static_assert(sizeof(ProcessMap::run) == 4 * sizeof(int), "runs are communicated as MPI_INT");
+    const int run_ints = 4;
+
     int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+
+    MPI_Comm leader_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leader_comm);
+
+    std::vector<ProcessMap::run> runs{};
+    std::vector<int> hostname_offsets{};
+    std::vector<char> hostnames{};
+    int sizes[3]; // number of runs, number of nodes, local node id
+
+    if (leader_comm != MPI_COMM_NULL) {
+        int nnodes;
+        MPI_Comm_size(leader_comm, &nnodes);
+        int node;
+        MPI_Comm_rank(leader_comm, &node);
+
+        auto node_runs = local_runs(local_ranks, node);
+        int run_count = static_cast<int>(node_runs.size()) * run_ints;
+        std::vector<int> run_counts(nnodes), run_displs{};
+        MPI_Allgather(&run_count, 1, MPI_INT, run_counts.data(), 1, MPI_INT, leader_comm);
+        runs.resize(displacements(run_counts, run_displs) / run_ints);
+        MPI_Allgatherv(node_runs.data(), run_count, MPI_INT, runs.data(), run_counts.data(), run_displs.data(), MPI_INT, leader_comm);
+        std::sort(runs.begin(), runs.end(), [](const auto &a, const auto &b) { return a.first_rank < b.first_rank; });
+
+        int hostname_length = static_cast<int>(strlen(hostname));
+        std::vector<int> hostname_lengths(nnodes);
+        MPI_Allgather(&hostname_length, 1, MPI_INT, hostname_lengths.data(), 1, MPI_INT, leader_comm);
+        hostnames.resize(displacements(hostname_lengths, hostname_offsets));
+        MPI_Allgatherv(hostname, hostname_length, MPI_CHAR, hostnames.data(), hostname_lengths.data(), hostname_offsets.data(), MPI_CHAR, leader_comm);
+        hostname_offsets.push_back(static_cast<int>(hostnames.size()));
+
+        sizes[0] = static_cast<int>(runs.size());
+        sizes[1] = nnodes;
+        sizes[2] = node;
+        MPI_Comm_free(&leader_comm);
+    }
 
-    char hostnames[nbproc][MPI_MAX_PROCESSOR_NAME];
-    MPI_Allgather(hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, hostnames, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, MPI_COMM_WORLD);
+    MPI_Bcast(sizes, 3, MPI_INT, 0, node_comm);
+    runs.resize(sizes[0]);
+    hostname_offsets.resize(sizes[1] + 1);
+    MPI_Bcast(runs.data(), sizes[0] * run_ints, MPI_INT, 0, node_comm);
+    MPI_Bcast(hostname_offsets.data(), sizes[1] + 1, MPI_INT, 0, node_comm);
+    hostnames.resize(hostname_offsets.back());
+    MPI_Bcast(hostnames.data(), hostname_offsets.back(), MPI_CHAR, 0, node_comm);
+
+    std::vector<std::string> node_hostnames(sizes[1]);
+    for (int node = 0; node < sizes[1]; ++node) {
+        node_hostnames[node].assign(hostnames.data() + hostname_offsets[node], hostnames.data() + hostname_offsets[node + 1]);
+    }
+    return ProcessMap{std::move(runs), std::move(node_hostnames), sizes[2]};
+}
+
+/* adds the vertex of an MPI process below parent_vd */
+static vertex_descriptor_t add_process_vertex(Graph &g, int rank, vertex_descriptor_t parent_vd, AffinityMask mask)
+{
+    // vertex_descriptor_t proc_vd = g.add_vertex("mpi_rank:" + std::to_string(i));
+    vertex_descriptor_t proc_vd = g.add_vertex();
 
+    g[proc_vd].type = MPIProcess::ptr();
+    MPIAdapter *adapter = new MPIAdapter{rank};
+    g[proc_vd].add_adapter(adapter);
+
+    // get affinity of mpi processes on local node
+    if (mask.any()) {
+        adapter->set_cpu_affinity_mask(mask);
+        parent_vd = lowest_containing_vertex(mask);
+    }
+
+    // add edges from mpi process nodes to compute nodes
+    g.add_relation(parent_vd, proc_vd);
+    g.process_map().set_vertex(rank, proc_vd);
+    return proc_vd;
+}
+
+/* vertex of a remote process, only known by its node since affinity masks are exchanged within nodes */
+static vertex_descriptor_t materialize_process_vertex(Graph &g, int rank)
+{
+    auto location = g.process_map().locate(rank).value();
+    vertex_descriptor_t node_vd = g.add_vertex("machine:" + g.process_map().hostname(location.node));
+    vertex_descriptor_t proc_vd = add_process_vertex(g, rank, node_vd, AffinityMask{});
+    attach_process_to_instance(g, proc_vd, rank);
+    return proc_vd;
+}
+
+/**
+ * @brief Adds MPI processes to the graph.
+ *
+ * In partitioned mode only processes on the local node become vertices, the other ranks are
+ * added on demand by ProcessMap::vertex().
+ */
+static void make_mpi_graph(Graph &g, const char *hostname, bool partitioned, MPI_Comm node_comm)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int node_size;
+    MPI_Comm_size(node_comm, &node_size);
+
+    std::vector<int> local_ranks(node_size);
+    MPI_Allgather(&rank, 1, MPI_INT, local_ranks.data(), 1, MPI_INT, node_comm);
+
+    // affinity masks are only needed for processes on the local node
     cpu_set_t cpuset;
     sched_getaffinity(0, sizeof(cpu_set_t), &cpuset);
-    cpu_set_t cpusets[nbproc];
-    MPI_Allgather(&cpuset, sizeof(cpu_set_t), MPI_BYTE, cpusets, sizeof(cpu_set_t), MPI_BYTE, MPI_COMM_WORLD);
-
-    for (int i = 0; i < nbproc; i++) {
-        vertex_descriptor_t node_vd = g.add_vertex("machine:" + std::string{hostnames[i]});
-        // vertex_descriptor_t proc_vd = g.add_vertex("mpi_rank:" + std::to_string(i));
-        vertex_descriptor_t proc_vd = g.add_vertex();
-
-        g[proc_vd].type = MPIProcess::ptr();
-        MPIAdapter *adapter = new MPIAdapter{i};
-        g[proc_vd].add_adapter(adapter);
-
-        // get affinity of mpi processes on local node
-        if (!strcmp(hostnames[i], hostname)) {
-            AffinityMask mask{cpusets[i]};
-            if (mask.any()) {
-                adapter->set_cpu_affinity_mask(mask);
-                node_vd = lowest_containing_vertex(mask);
-            }
+    AffinityMask mask{cpuset};
+    std::vector<AffinityMask> masks(node_size);
+    MPI_Allgather(&mask, sizeof(AffinityMask), MPI_BYTE, masks.data(), sizeof(AffinityMask), MPI_BYTE, node_comm);
+
+    g.set_process_map(gather_process_map(node_comm, local_ranks, hostname));
+
+    ProcessMap &map = g.process_map();
+    map.set_materializer(materialize_process_vertex);
+
+    std::vector<vertex_descriptor_t> node_vds(map.num_nodes());
+    for (int node = 0; node < map.num_nodes(); ++node) {
+        if (!partitioned || node == map.local_node()) {
+            node_vds[node] = g.add_vertex("machine:" + map.hostname(node));
         }
+    }
 
-        // add edges from mpi process nodes to compute nodes
-        boost::add_edge(node_vd, proc_vd, Edge{edge_type::CHILD}, g);
-        boost::add_edge(proc_vd, node_vd, Edge{edge_type::PARENT}, g);
+    // runs are sorted, so vertices are added in rank order
+    for (const auto &run : map.runs()) {
+        bool local = run.node == map.local_node();
+        if (partitioned && !local) {
+            continue;
+        }
+        for (int i = 0; i < run.count; ++i) {
+            add_process_vertex(g, run.first_rank + i, node_vds[run.node], local ? masks[run.first_local_index + i] : AffinityMask{});
+        }
     }
 }
 
@@ -68,7 +204,16 @@ yloc_status_t ModuleMPI::init_graph(Graph &g)
     int hostname_length;
     MPI_Get_processor_name(hostname, &hostname_length);
 
-    make_mpi_graph(g, hostname);
+    // processes sharing memory are on the same node, key 0 keeps the order of world ranks
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+
+    make_mpi_graph(g, hostname, init_flags() & YLOC_PARTITIONED, node_comm);
+    if (init_flags() & YLOC_CLUSTER) {
+        assemble_cluster_graph(g, node_comm);
+    }
+
+    MPI_Comm_free(&node_comm);
 
     return YLOC_STATUS_SUCCESS;
 }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <yloc/graph.h>
 #include <yloc/modules/module.h>
 
+#include <mpi.h>
+
 namespace yloc
 {
     class ModuleMPI : public Module
@@ -23,5 +26,17 @@ namespace yloc
         };
 
     private:
+        /**
+         * @brief Adds the hardware subgraphs of all remote machines below their machine vertices.
+         *
+         * Node leaders exchange snapshots of their machine, identical machines are sent only once
+         * and shared by all remote machine vertices of that kind as a node template.
+         */
+        void assemble_cluster_graph(Graph &graph, MPI_Comm node_comm);
     };
+
+    /**
+     * @brief Attaches the vertex of a remote process to its location in the template instance of its machine, if known.
+     */
+    void attach_process_to_instance(Graph &graph, vertex_descriptor_t process_vd, int rank);
 }
\ No newline at end of file
@@ -2,11 +2,19 @@
 
 #include <yloc/modules/module.h>
 
+#include <utility>
+#include <vector>
+
 namespace yloc
 {
+    class Adapter;
+    class SampledAdapter;
+
     class ModuleNvml : public Module
     {
     public:
+        ModuleNvml() { m_update_interval = std::chrono::milliseconds{100}; }
+
         yloc_status_t init_graph(Graph &graph) override;
 
         yloc_status_t export_graph(const Graph &graph, void **output) override
@@ -14,11 +22,13 @@ namespace yloc
             return YLOC_STATUS_NOT_SUPPORTED;
         }
 
-        yloc_status_t update_graph(Graph &graph) override
-        {
-            return YLOC_STATUS_NOT_SUPPORTED;
-        }
+        /**
+         * @brief Samples the dynamic properties of all devices (YLOC_ONGOING).
+         */
+        yloc_status_t update_graph(Graph &graph) override;
 
     private:
+        /** sampled adapters of the devices and the adapters they sample from */
+        std::vector<std::pair<SampledAdapter *, Adapter *>> m_sampled{};
     };
 }
\ No newline at end of file
@@ -3,8 +3,10 @@
 #include <vector>
 
 #include <yloc/graph.h>
+#include <yloc/init.h>
 #include <yloc/modules/adapter.h>
 #include <yloc/modules/module.h>
+#include <yloc/sampling.h>
 #include <yloc/status.h>
 
 #include "interface_impl.h"
@@ -72,8 +74,7 @@ static uint64_t yloc_nvml_gpu_interconnect(Graph &g, uint32_t num_devices, std::
                 num_interconnects++;
                 // std::cout << "link gpu indices: " << dev_ind_src << " <-> " << dev_ind_dst << '\n';
                 // std::cout << "link graph vds: " << vertices[dev_ind_src] << " <-> " << vertices[dev_ind_dst] << '\n';
-                auto ed = boost::add_edge(vertices[dev_ind_src], vertices[dev_ind_dst], Edge{edge_type::GPU_INTERCONNECT}, g);
-                ed = boost::add_edge(vertices[dev_ind_dst], vertices[dev_ind_src], Edge{edge_type::GPU_INTERCONNECT}, g);
+                g.add_relation(vertices[dev_ind_src], vertices[dev_ind_dst], edge_type::GPU_INTERCONNECT);
             }
         }
     }
@@ -116,8 +117,11 @@ yloc_status_t ModuleNvml::init_graph(Graph &g)
 
         // associate nvml device with graph node by pcie bdfid:
         auto vd = g.add_vertex("bdfid:" + std::to_string(bdfid));
-        g[vd].add_adapter(new NvmlAdapter{device});
+        g[vd].add_adapter(a);
         vertices[dev_index] = vd;
+        if (init_flags() & YLOC_ONGOING) {
+            m_sampled.emplace_back(sampled_adapter(g, vd), a);
+        }
 
         assert(g[vd].type->is_a<PCIDevice>());
         g[vd].type = GPU::ptr();
@@ -126,3 +130,14 @@ yloc_status_t ModuleNvml::init_graph(Graph &g)
     uint64_t num_interconnects = yloc_nvml_gpu_interconnect(g, num_devices, vertices, devices);
     return YLOC_STATUS_SUCCESS;
 }
+
+yloc_status_t ModuleNvml::update_graph(Graph &g)
+{
+    if (m_sampled.empty()) {
+        return YLOC_STATUS_NOT_SUPPORTED;
+    }
+    for (auto [sampled, adapter] : m_sampled) {
+        sampled->sample_from(adapter, m_update_interval);
+    }
+    return YLOC_STATUS_SUCCESS;
+}
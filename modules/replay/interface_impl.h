@@ -0,0 +1,52 @@
+#pragma once
+
+#include <yloc/modules/module.h>
+#include <yloc/replay.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yloc
+{
+    class Adapter;
+    class SampledAdapter;
+
+    /**
+     * @brief Serves the dynamic properties of vertices from a recording (see Replay).
+     *
+     * Enabled by the environment variable YLOC_REPLAY_FILE, the path of the recording.
+     * YLOC_REPLAY_SPEED is the playback speed, 1 (real time) by default, or "max" to play the
+     * samples as fast as possible (requires YLOC_ONGOING, the sampler steps through them).
+     * Recorded vertices are found by their identifier (or "vd:<descriptor>"), missing ones are
+     * added as GPUs below the root, so that recordings of GPU nodes can be replayed anywhere.
+     * Samples keep the time intervals of the recording, so with a speed other than 1 their times
+     * run ahead of or behind the steady clock.
+     */
+    class ModuleReplay : public Module
+    {
+    public:
+        ModuleReplay();
+
+        yloc_status_t init_graph(Graph &graph) override;
+
+        yloc_status_t export_graph(const Graph &graph, void **output) override
+        {
+            return YLOC_STATUS_NOT_SUPPORTED;
+        }
+
+        /**
+         * @brief Samples the replayed properties at the playback position (YLOC_ONGOING).
+         */
+        yloc_status_t update_graph(Graph &graph) override;
+
+    private:
+        std::string m_path{};
+        double m_speed{1};
+        Replay m_replay{};
+        int64_t m_time_offset{0}; // from recorded time to steady clock
+
+        /** sampled adapters of the replayed vertices and the adapters they sample from */
+        std::vector<std::pair<SampledAdapter *, Adapter *>> m_sampled{};
+    };
+}
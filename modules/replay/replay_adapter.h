@@ -0,0 +1,51 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <yloc/modules/adapter.h>
+#include <yloc/replay.h>
+#include <yloc/sampling.h>
+
+namespace yloc
+{
+    class ReplayAdapter : public Adapter
+    {
+    public:
+        ReplayAdapter(const Replay &replay, std::string vertex)
+            : m_replay{replay}, m_vertex{std::move(vertex)}, m_series(dynamic_properties().size()) {}
+
+        std::string to_string() const override { return "replay of " + m_vertex; }
+
+        /**
+         * @brief Serves property (index in dynamic_properties()) from the recorded series.
+         */
+        void set_series(size_t property, size_t series) { m_series[property] = series; }
+
+        std::optional<uint64_t> memory_usage() const override { return value("memory_usage"); }
+        std::optional<uint64_t> memory_load() const override { return value("memory_load"); }
+        std::optional<uint64_t> throughput() const override { return value("throughput"); }
+        std::optional<uint64_t> power() const override { return value("power"); }
+        std::optional<uint64_t> usage() const override { return value("usage"); }
+        std::optional<uint64_t> load() const override { return value("load"); }
+        std::optional<uint64_t> pci_throughput() const override { return value("pci_throughput"); }
+        std::optional<uint64_t> pci_throughput_read() const override { return value("pci_throughput_read"); }
+        std::optional<uint64_t> pci_throughput_write() const override { return value("pci_throughput_write"); }
+
+    private:
+        std::optional<uint64_t> value(std::string_view property) const
+        {
+            auto index = dynamic_property_index(property);
+            if (!index.has_value() || !m_series[*index].has_value()) {
+                return {};
+            }
+            return m_replay.value(*m_series[*index]);
+        }
+
+        const Replay &m_replay;
+        std::string m_vertex;
+        std::vector<std::optional<size_t>> m_series; // by index in dynamic_properties()
+    };
+}
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include <yloc/graph.h>
+#include <yloc/init.h>
+#include <yloc/modules/module.h>
+#include <yloc/sampling.h>
+#include <yloc/status.h>
+
+#include "interface_impl.h"
+#include "replay_adapter.h"
+
+using namespace yloc;
+
+ModuleReplay::ModuleReplay()
+{
+    // runs after the hwloc module, so that recorded devices are found by their bdfid
+    m_init_order = Module::init_order::SECOND;
+
+    const char *path = std::getenv("YLOC_REPLAY_FILE");
+    m_enabled = path != nullptr && *path != '\0';
+    if (m_enabled) {
+        m_path = path;
+        const char *speed = std::getenv("YLOC_REPLAY_SPEED");
+        if (speed != nullptr && std::string{speed} == "max") {
+            m_speed = 0;
+        } else if (speed != nullptr && std::strtod(speed, nullptr) > 0) {
+            m_speed = std::strtod(speed, nullptr);
+        }
+    }
+}
+
+/* vertex of a recorded vertex name, added below the root if the graph does not have it */
+static vertex_descriptor_t replay_vertex(Graph &g, const std::string &name)
+{
+    if (name.rfind("vd:", 0) == 0) {
+        char *end;
+        unsigned long vd = std::strtoul(name.c_str() + 3, &end, 10);
+        if (*end == '\0' && vd < boost::num_vertices(g)) {
+            return vd;
+        }
+    }
+    auto iter = g.identifier_map().find(name);
+    if (iter != g.identifier_map().end()) {
+        return iter->second;
+    }
+    auto vd = g.add_vertex(name);
+    g.add_relation(g.get_root_vertex(), vd);
+    g[vd].type = GPU::ptr();
+    g[vd].m_description = name;
+    return vd;
+}
+
+yloc_status_t ModuleReplay::init_graph(Graph &g)
+{
+    yloc_status_t status = m_replay.open(m_path);
+    if (status != YLOC_STATUS_SUCCESS) {
+        std::cerr << "yloc-replay: cannot read a recording from " << m_path << '\n';
+        return status;
+    }
+
+    std::unordered_map<std::string, ReplayAdapter *> adapters{};
+    const auto &recorded = m_replay.recorded();
+    for (size_t s = 0; s < recorded.size(); ++s) {
+        auto iter = adapters.find(recorded[s].vertex);
+        if (iter == adapters.end()) {
+            auto vd = replay_vertex(g, recorded[s].vertex);
+            auto *adapter = new ReplayAdapter{m_replay, recorded[s].vertex};
+            // replayed values take precedence over the adapters of other modules
+            auto &v_adapters = g[vd].m_adapters;
+            v_adapters.insert(find_sampled_adapter(g[vd]) != nullptr ? v_adapters.begin() + 1 : v_adapters.begin(), adapter);
+            if (init_flags() & YLOC_ONGOING) {
+                m_sampled.emplace_back(sampled_adapter(g, vd), adapter);
+            }
+            iter = adapters.emplace(recorded[s].vertex, adapter).first;
+        }
+        iter->second->set_series(recorded[s].property, s);
+    }
+
+    m_replay.start(m_speed);
+    // samples are stamped with their recorded time, moved onto the steady clock at the start
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    m_time_offset = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - m_replay.position();
+    if (init_flags() & YLOC_ONGOING) {
+        m_update_interval = std::chrono::milliseconds{100};
+    }
+    return YLOC_STATUS_SUCCESS;
+}
+
+yloc_status_t ModuleReplay::update_graph(Graph &g)
+{
+    if (m_sampled.empty()) {
+        return YLOC_STATUS_NOT_SUPPORTED;
+    }
+    // as fast as possible: every recorded time is sampled, for up to one update interval per call
+    auto end = std::chrono::steady_clock::now() + m_update_interval;
+    do {
+        int64_t time = m_replay.position() + m_time_offset;
+        for (auto [sampled, adapter] : m_sampled) {
+            sampled->sample_from(adapter, std::chrono::nanoseconds{0}, time);
+        }
+    } while (m_replay.speed() == 0 && m_replay.step() && std::chrono::steady_clock::now() < end);
+    return YLOC_STATUS_SUCCESS;
+}
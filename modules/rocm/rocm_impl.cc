@@ -3,8 +3,10 @@
 #include <vector>
 
 #include <yloc/graph.h>
+#include <yloc/init.h>
 #include <yloc/modules/adapter.h>
 #include <yloc/modules/module.h>
+#include <yloc/sampling.h>
 #include <yloc/status.h>
 
 #include "interface_impl.h"
@@ -53,8 +55,7 @@ static uint64_t yloc_rocm_gpu_interconnect(Graph &g, uint32_t num_devices, std::
                 std::cout << "link gpu indices: " << dev_ind_src << " <-> " << dev_ind_dst << '\n';
                 std::cout << "link graph vds: " << vertices[dev_ind_src] << " <-> " << vertices[dev_ind_dst] << '\n';
                 
-                auto ret = boost::add_edge(vertices[dev_ind_src], vertices[dev_ind_dst], Edge{edge_type::YLOC_GPU_INTERCONNECT}, g);
-                ret = boost::add_edge(vertices[dev_ind_dst], vertices[dev_ind_src], Edge{edge_type::YLOC_GPU_INTERCONNECT}, g);
+                g.add_relation(vertices[dev_ind_src], vertices[dev_ind_dst], edge_type::GPU_INTERCONNECT);
             }
         }
     }
@@ -118,6 +119,9 @@ yloc_status_t ModuleRocm::init_graph(Graph &g)
         g[vd].m_description = adapter->to_string();
 
         vertices[dev_index] = vd;
+        if (init_flags() & YLOC_ONGOING) {
+            m_sampled.emplace_back(sampled_adapter(g, vd), adapter);
+        }
         // std::cout << YLOC_GET(g, vd, as_string).value() << '\n';
         // std::cout << "yloc type: " << g[vd].type->to_string() << " vd: " << vd << '\n';
 
@@ -131,6 +135,17 @@ yloc_status_t ModuleRocm::init_graph(Graph &g)
     return YLOC_STATUS_SUCCESS;
 }
 
+yloc_status_t ModuleRocm::update_graph(Graph &g)
+{
+    if (m_sampled.empty()) {
+        return YLOC_STATUS_NOT_SUPPORTED;
+    }
+    for (auto [sampled, adapter] : m_sampled) {
+        sampled->sample_from(adapter, m_update_interval);
+    }
+    return YLOC_STATUS_SUCCESS;
+}
+
 #if YLOC_ROCM_NOT_IMPLEMENTED_YET
 /************************************************/
 Hardware Topology Functions
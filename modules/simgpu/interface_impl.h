@@ -0,0 +1,50 @@
+#pragma once
+
+#include <yloc/modules/module.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "simgpu_driver.h"
+
+namespace yloc
+{
+    class Adapter;
+    class SampledAdapter;
+
+    /**
+     * @brief Adds simulated GPUs, to test device discovery and sampling at scale without hardware.
+     *
+     * Enabled by the environment variable YLOC_SIMGPU_COUNT, the number of devices. Further:
+     *   YLOC_SIMGPU_TOPOLOGY  links between the devices: none, ring (default), mesh, hypercube or
+     *                         islands:<size> (fully linked islands, 4 devices by default)
+     *   YLOC_SIMGPU_LATENCY   latency of every driver call in microseconds (default 0)
+     *   YLOC_SIMGPU_SPIN      if 1, calls busy-wait instead of sleeping, so that they cost cpu time
+     * Devices are found by their synthetic bdfid (e.g. in a topology from HWLOC_XMLFILE), missing
+     * ones are attached to the host bridges of the hwloc topology in turn, or to the root.
+     */
+    class ModuleSimGpu : public Module
+    {
+    public:
+        ModuleSimGpu();
+
+        yloc_status_t init_graph(Graph &graph) override;
+
+        yloc_status_t export_graph(const Graph &graph, void **output) override
+        {
+            return YLOC_STATUS_NOT_SUPPORTED;
+        }
+
+        /**
+         * @brief Samples the dynamic properties of all devices (YLOC_ONGOING).
+         */
+        yloc_status_t update_graph(Graph &graph) override;
+
+    private:
+        std::unique_ptr<SimGpuDriver> m_driver{};
+
+        /** sampled adapters of the devices and the adapters they sample from */
+        std::vector<std::pair<SampledAdapter *, Adapter *>> m_sampled{};
+    };
+}
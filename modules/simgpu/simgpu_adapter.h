@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+#include <yloc/modules/adapter.h>
+
+#include "simgpu_driver.h"
+
+namespace yloc
+{
+    class SimGpuAdapter : public Adapter
+    {
+        using obj_t = uint32_t; // simulated device index
+
+    public:
+        SimGpuAdapter(const SimGpuDriver &driver, obj_t obj) : m_driver{driver}, m_obj{obj} {}
+
+        std::string to_string() const override { return "Simulated GPU " + std::to_string(m_obj); }
+
+        std::optional<uint64_t> memory() const override { return SimGpuDriver::memory_total; }
+
+        std::optional<uint64_t> memory_usage() const override { return m_driver.memory_usage(m_obj); }
+
+        std::optional<uint64_t> memory_load() const override { return m_driver.memory_load(m_obj); }
+
+        std::optional<uint64_t> bdfid() const override { return m_driver.bdfid(m_obj); }
+
+        std::optional<uint64_t> load() const override { return m_driver.load(m_obj); }
+
+        std::optional<uint64_t> power() const override { return m_driver.power(m_obj); }
+
+        std::optional<uint64_t> pci_throughput() const override
+        {
+            return m_driver.pci_throughput_read(m_obj) + m_driver.pci_throughput_write(m_obj);
+        }
+
+        std::optional<uint64_t> pci_throughput_read() const override { return m_driver.pci_throughput_read(m_obj); }
+
+        std::optional<uint64_t> pci_throughput_write() const override { return m_driver.pci_throughput_write(m_obj); }
+
+        obj_t native_obj() const { return m_obj; }
+
+    private:
+        const SimGpuDriver &m_driver;
+        obj_t m_obj;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace yloc
+{
+    enum class simgpu_topology : int {
+        NONE = 0,  /**< no direct links, devices only communicate over PCIe */
+        RING,      /**< device i is linked to i - 1 and i + 1 (modulo the number of devices) */
+        MESH,      /**< all devices are linked to each other */
+        HYPERCUBE, /**< devices whose indices differ in one bit are linked */
+        ISLANDS    /**< fully linked islands of island_size consecutive devices */
+    };
+
+    struct simgpu_config {
+        uint32_t num_devices{0};
+        simgpu_topology topology{simgpu_topology::RING};
+        uint32_t island_size{4};
+        std::chrono::nanoseconds latency{0}; // of every driver call
+        bool spin{false};                    // busy-wait for the latency instead of sleeping
+    };
+
+    /**
+     * @brief Stand-in for a device management library (like NVML or ROCm SMI) of simulated GPUs.
+     *
+     * Every call takes the configured latency. Dynamic values follow slow sine waves with a phase
+     * per device, so they change between samples but are reproducible.
+     */
+    class SimGpuDriver
+    {
+    public:
+        static constexpr uint64_t memory_total = uint64_t{80} << 30; // bytes
+
+        explicit SimGpuDriver(simgpu_config config) : m_config{config}, m_start{std::chrono::steady_clock::now()} {}
+
+        const simgpu_config &config() const { return m_config; }
+
+        uint32_t device_count() const
+        {
+            call();
+            return m_config.num_devices;
+        }
+
+        /**
+         * @return Synthetic PCI id, in the bdfid format of the hwloc module (domain, bus, device, function).
+         */
+        uint64_t bdfid(uint32_t dev) const
+        {
+            call();
+            uint64_t domain = dev / 224;
+            uint64_t bus = 0x20 + dev % 224;
+            return (domain << 32) | (bus << 8);
+        }
+
+        /**
+         * @return Whether devices a and b are directly linked.
+         */
+        bool p2p_link(uint32_t a, uint32_t b) const
+        {
+            call();
+            uint32_t n = m_config.num_devices;
+            if (a == b || a >= n || b >= n) {
+                return false;
+            }
+            switch (m_config.topology) {
+            case simgpu_topology::RING:
+                return (a + 1) % n == b || (b + 1) % n == a;
+            case simgpu_topology::MESH:
+                return true;
+            case simgpu_topology::HYPERCUBE:
+                return __builtin_popcount(a ^ b) == 1;
+            case simgpu_topology::ISLANDS:
+                return a / m_config.island_size == b / m_config.island_size;
+            default:
+                return false;
+            }
+        }
+
+        /** load of the compute units in percent */
+        uint64_t load(uint32_t dev) const { return wave(dev, 60.0, 0, 100); }
+
+        /** load of the memory in percent */
+        uint64_t memory_load(uint32_t dev) const { return wave(dev, 90.0, 0, 100); }
+
+        uint64_t memory_usage(uint32_t dev) const { return memory_total / 100 * memory_load(dev); }
+
+        /** power in milliwatts */
+        uint64_t power(uint32_t dev) const { return wave(dev, 60.0, 80000, 400000); }
+
+        /** pci throughput in bytes per second */
+        uint64_t pci_throughput_read(uint32_t dev) const { return wave(dev, 20.0, 0, uint64_t{16} << 30); }
+        uint64_t pci_throughput_write(uint32_t dev) const { return wave(dev, 30.0, 0, uint64_t{8} << 30); }
+
+    private:
+        void call() const
+        {
+            if (m_config.latency.count() <= 0) {
+                return;
+            }
+            if (!m_config.spin) {
+                std::this_thread::sleep_for(m_config.latency);
+                return;
+            }
+            auto end = std::chrono::steady_clock::now() + m_config.latency;
+            while (std::chrono::steady_clock::now() < end) {
+            }
+        }
+
+        /* value between min and max with the given period in seconds */
+        uint64_t wave(uint32_t dev, double period, uint64_t min, uint64_t max) const
+        {
+            call();
+            double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+            double phase = 0.7 * dev;
+            double x = 0.5 + 0.5 * std::sin(2 * M_PI * t / period + phase);
+            return min + static_cast<uint64_t>(x * static_cast<double>(max - min));
+        }
+
+        simgpu_config m_config;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
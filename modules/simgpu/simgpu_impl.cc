@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <yloc/graph.h>
+#include <yloc/init.h>
+#include <yloc/modules/adapter.h>
+#include <yloc/modules/module.h>
+#include <yloc/sampling.h>
+#include <yloc/status.h>
+
+#include "interface_impl.h"
+#include "simgpu_adapter.h"
+#include "simgpu_driver.h"
+
+using namespace yloc;
+
+static simgpu_config simgpu_config_from_env()
+{
+    simgpu_config config{};
+    if (const char *count = std::getenv("YLOC_SIMGPU_COUNT")) {
+        config.num_devices = static_cast<uint32_t>(std::strtoul(count, nullptr, 10));
+    }
+    if (const char *topology = std::getenv("YLOC_SIMGPU_TOPOLOGY")) {
+        std::string name{topology};
+        if (name == "none") {
+            config.topology = simgpu_topology::NONE;
+        } else if (name == "mesh") {
+            config.topology = simgpu_topology::MESH;
+        } else if (name == "hypercube") {
+            config.topology = simgpu_topology::HYPERCUBE;
+        } else if (name.rfind("islands", 0) == 0) {
+            config.topology = simgpu_topology::ISLANDS;
+            if (name.size() > 8 && name[7] == ':') {
+                config.island_size = std::max(1UL, std::strtoul(name.c_str() + 8, nullptr, 10));
+            }
+        }
+    }
+    if (const char *latency = std::getenv("YLOC_SIMGPU_LATENCY")) {
+        config.latency = std::chrono::microseconds{std::strtol(latency, nullptr, 10)};
+    }
+    if (const char *spin = std::getenv("YLOC_SIMGPU_SPIN")) {
+        config.spin = std::strcmp(spin, "1") == 0;
+    }
+    return config;
+}
+
+ModuleSimGpu::ModuleSimGpu()
+{
+    // runs after the hwloc module, so that devices are attached to its host bridges
+    m_init_order = Module::init_order::SECOND;
+    m_update_interval = std::chrono::milliseconds{100};
+
+    simgpu_config config = simgpu_config_from_env();
+    m_enabled = config.num_devices > 0;
+    if (m_enabled) {
+        m_driver = std::make_unique<SimGpuDriver>(config);
+    }
+}
+
+/* same discovery as the nvml and rocm modules: a driver call for every pair of devices */
+static uint64_t yloc_simgpu_gpu_interconnect(Graph &g, const SimGpuDriver &driver, uint32_t num_devices, std::vector<vertex_descriptor_t> &vertices)
+{
+    uint64_t num_interconnects = 0;
+    for (uint32_t dev_ind_src = 0; dev_ind_src < num_devices; ++dev_ind_src) {
+        for (uint32_t dev_ind_dst = dev_ind_src + 1; dev_ind_dst < num_devices; ++dev_ind_dst) {
+            if (driver.p2p_link(dev_ind_src, dev_ind_dst)) {
+                num_interconnects++;
+                g.add_relation(vertices[dev_ind_src], vertices[dev_ind_dst], edge_type::GPU_INTERCONNECT);
+            }
+        }
+    }
+    return num_interconnects;
+}
+
+/* bridges directly below a non-bridge, i.e. the host bridges of the hwloc topology */
+static std::vector<vertex_descriptor_t> host_bridges(const Graph &g)
+{
+    std::vector<vertex_descriptor_t> bridges{};
+    for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+        auto parent = g.parent(vd);
+        if (g[vd].type->is_a<Bridge>() && (!parent.has_value() || !g[*parent].type->is_a<Bridge>())) {
+            bridges.push_back(vd);
+        }
+    }
+    return bridges;
+}
+
+yloc_status_t ModuleSimGpu::init_graph(Graph &g)
+{
+    if (!m_driver) {
+        return YLOC_STATUS_NOT_SUPPORTED;
+    }
+    uint32_t num_devices = m_driver->device_count();
+    std::vector<vertex_descriptor_t> vertices(num_devices);
+    std::vector<vertex_descriptor_t> bridges = host_bridges(g);
+
+    for (uint32_t dev_index = 0; dev_index < num_devices; ++dev_index) {
+        SimGpuAdapter *adapter = new SimGpuAdapter{*m_driver, dev_index};
+        std::string id = "bdfid:" + std::to_string(m_driver->bdfid(dev_index));
+
+        // associate simulated device with graph node by its synthetic bdfid
+        bool known = g.identifier_map().count(id) != 0;
+        auto vd = g.add_vertex(id);
+        if (!known) {
+            g.add_relation(bridges.empty() ? g.get_root_vertex() : bridges[dev_index % bridges.size()], vd);
+        }
+        g[vd].add_adapter(adapter);
+        g[vd].m_description = adapter->to_string();
+        vertices[dev_index] = vd;
+        if (init_flags() & YLOC_ONGOING) {
+            m_sampled.emplace_back(sampled_adapter(g, vd), adapter);
+        }
+
+        g[vd].type = GPU::ptr();
+    }
+    yloc_simgpu_gpu_interconnect(g, *m_driver, num_devices, vertices);
+    return YLOC_STATUS_SUCCESS;
+}
+
+yloc_status_t ModuleSimGpu::update_graph(Graph &g)
+{
+    if (m_sampled.empty()) {
+        return YLOC_STATUS_NOT_SUPPORTED;
+    }
+    for (auto [sampled, adapter] : m_sampled) {
+        sampled->sample_from(adapter, m_update_interval);
+    }
+    return YLOC_STATUS_SUCCESS;
+}
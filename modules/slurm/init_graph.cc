@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <yloc/yloc.h>
+
+#include "interface_impl.h"
+#include "slurm_adapter.h"
+#include "topology_conf.h"
+
+using namespace yloc;
+
+ModuleSlurm::ModuleSlurm()
+{
+    // the switch hierarchy is static and the same on every process of a node
+    m_shareable = true;
+
+    const char *topology_file = std::getenv("YLOC_TOPOLOGY_CONF");
+    m_enabled = topology_file != nullptr && *topology_file != '\0';
+    if (m_enabled) {
+        m_topology_file = topology_file;
+        const char *switch_map_file = std::getenv("YLOC_SWITCH_MAP");
+        m_switch_map_file = switch_map_file != nullptr ? switch_map_file : "";
+    }
+}
+
+static yloc_status_t parse_file(const std::string &path, std::vector<slurm_switch> &switches,
+                                yloc_status_t (*parse)(std::istream &, std::vector<slurm_switch> &))
+{
+    std::ifstream input{path};
+    if (!input) {
+        std::cerr << "cannot open " << path << '\n';
+        return YLOC_STATUS_NOT_FOUND;
+    }
+    return parse(input, switches);
+}
+
+/**
+ * @brief Adds switch vertices and the machines below them.
+ *
+ * Switches and machines may be listed by several switches (e.g. a fat tree), duplicate
+ * relations are ignored by Graph::add_relation().
+ */
+static void make_switch_graph(Graph &g, const std::vector<slurm_switch> &switches)
+{
+    auto switch_vertex = [&](const std::string &name) {
+        vertex_descriptor_t vd = g.add_vertex("switch:" + name);
+        if (g[vd].type == UnknownComponentType::ptr()) {
+            g[vd].type = Switch::ptr();
+            g[vd].m_description = name;
+        }
+        return vd;
+    };
+
+    for (const auto &sw : switches) {
+        vertex_descriptor_t switch_vd = switch_vertex(sw.name);
+        g[switch_vd].add_adapter(new SlurmSwitchAdapter{sw.name, sw.link_speed});
+
+        for (const auto &child : sw.switches) {
+            g.add_relation(switch_vd, switch_vertex(child));
+        }
+        for (const auto &hostname : sw.nodes) {
+            vertex_descriptor_t machine_vd = g.add_vertex("machine:" + hostname);
+            if (g[machine_vd].type == UnknownComponentType::ptr()) {
+                g[machine_vd].type = Node::ptr();
+            }
+            if (g[machine_vd].m_description.empty()) {
+                g[machine_vd].m_description = hostname;
+            }
+            g.add_relation(switch_vd, machine_vd);
+        }
+    }
+}
+
+yloc_status_t ModuleSlurm::init_graph(Graph &g)
+{
+    std::vector<slurm_switch> switches{};
+    yloc_status_t status = parse_file(m_topology_file, switches, parse_topology_conf);
+    if (status == YLOC_STATUS_SUCCESS && !m_switch_map_file.empty()) {
+        status = parse_file(m_switch_map_file, switches, parse_switch_map);
+    }
+    if (status != YLOC_STATUS_SUCCESS) {
+        return status;
+    }
+
+    make_switch_graph(g, switches);
+
+    return YLOC_STATUS_SUCCESS;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <yloc/modules/module.h>
+
+#include <string>
+
+namespace yloc
+{
+    /**
+     * @brief Adds the network switches of a Slurm topology.conf above the machine vertices.
+     *
+     * Enabled by the environment variable YLOC_TOPOLOGY_CONF, the path of the topology file.
+     * YLOC_SWITCH_MAP optionally names a file that assigns further nodes to switches, one
+     * "<hostlist> <switch>" pair per line.
+     */
+    class ModuleSlurm : public Module
+    {
+    public:
+        ModuleSlurm();
+
+        yloc_status_t init_graph(Graph &graph) override;
+
+        yloc_status_t export_graph(const Graph &graph, void **output) override
+        {
+            output = nullptr;
+            return YLOC_STATUS_NOT_SUPPORTED;
+        }
+
+        yloc_status_t update_graph(Graph &graph) override
+        {
+            return YLOC_STATUS_NOT_SUPPORTED;
+        }
+
+    private:
+        std::string m_topology_file{};
+        std::string m_switch_map_file{};
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <yloc/modules/adapter.h>
+
+#include <string>
+
+namespace yloc
+{
+    class SlurmSwitchAdapter : public Adapter
+    {
+        using obj_t = std::string;
+
+    public:
+        SlurmSwitchAdapter(obj_t obj, std::optional<uint64_t> link_speed) : m_obj(obj), m_link_speed(link_speed) {}
+
+        std::string to_string() const override
+        {
+            return m_obj;
+        }
+
+        /** TODO: abstract machine model implementation **/
+
+        /** LinkSpeed of the switch's links to its children, in the (arbitrary) units of the topology file */
+        std::optional<uint64_t> link_speed() const override
+        {
+            return m_link_speed;
+        }
+
+        /** abstract machine model end **/
+
+        obj_t native_obj() const { return m_obj; }
+
+    private:
+        obj_t m_obj;
+        std::optional<uint64_t> m_link_speed;
+    };
+}
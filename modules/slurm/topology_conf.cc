@@ -0,0 +1,195 @@
+#include "topology_conf.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+using namespace yloc;
+
+static bool parse_number(std::string_view str, uint64_t &value)
+{
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc{} && ptr == str.data() + str.size() && !str.empty();
+}
+
+/* expands the first bracket expression of rest and recurses for the following ones */
+static bool expand_name(std::string &prefix, std::string_view rest, std::vector<std::string> &hostnames)
+{
+    size_t open = rest.find('[');
+    if (open == std::string_view::npos) {
+        hostnames.push_back(prefix + std::string{rest});
+        return rest.find(']') == std::string_view::npos;
+    }
+    size_t close = rest.find(']', open);
+    if (close == std::string_view::npos) {
+        return false;
+    }
+
+    size_t prefix_length = prefix.size();
+    prefix += rest.substr(0, open);
+    size_t base_length = prefix.size();
+    std::string_view ranges = rest.substr(open + 1, close - open - 1);
+    std::string_view tail = rest.substr(close + 1);
+
+    while (true) {
+        size_t comma = ranges.find(',');
+        std::string_view range = ranges.substr(0, comma);
+        size_t dash = range.find('-');
+        std::string_view lower = range.substr(0, dash);
+        uint64_t first, last;
+        if (!parse_number(lower, first) || !parse_number(dash == std::string_view::npos ? lower : range.substr(dash + 1), last) || last < first) {
+            return false;
+        }
+        for (uint64_t i = first; i <= last; ++i) {
+            std::string number = std::to_string(i);
+            prefix.resize(base_length);
+            prefix.append(number.size() < lower.size() ? lower.size() - number.size() : 0, '0');
+            prefix += number;
+            if (!expand_name(prefix, tail, hostnames)) {
+                return false;
+            }
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        ranges = ranges.substr(comma + 1);
+    }
+    prefix.resize(prefix_length);
+    return true;
+}
+
+bool yloc::expand_hostlist(std::string_view expression, std::vector<std::string> &hostnames)
+{
+    std::string prefix{};
+    size_t start = 0;
+    int depth = 0;
+    for (size_t i = 0; i <= expression.size(); ++i) {
+        if (i == expression.size() || (expression[i] == ',' && depth == 0)) {
+            if (i > start && !expand_name(prefix, expression.substr(start, i - start), hostnames)) {
+                return false;
+            }
+            start = i + 1;
+        } else if (expression[i] == '[') {
+            ++depth;
+        } else if (expression[i] == ']') {
+            --depth;
+        }
+    }
+    return depth == 0;
+}
+
+static bool iequals(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+/* reads the next logical line without comment, joining lines that end with a backslash */
+static bool read_line(std::istream &input, std::string &line, size_t &line_number)
+{
+    line.clear();
+    std::string part;
+    while (std::getline(input, part)) {
+        ++line_number;
+        part = part.substr(0, part.find('#'));
+        while (!part.empty() && std::isspace(static_cast<unsigned char>(part.back()))) {
+            part.pop_back();
+        }
+        if (!part.empty() && part.back() == '\\') {
+            part.pop_back();
+            line += part + ' ';
+            continue;
+        }
+        line += part;
+        return true;
+    }
+    return !line.empty();
+}
+
+static slurm_switch &find_switch(std::vector<slurm_switch> &switches, std::unordered_map<std::string, size_t> &index, const std::string &name)
+{
+    auto [iter, inserted] = index.try_emplace(name, switches.size());
+    if (inserted) {
+        switches.push_back(slurm_switch{name});
+    }
+    return switches[iter->second];
+}
+
+static std::unordered_map<std::string, size_t> switch_index(const std::vector<slurm_switch> &switches)
+{
+    std::unordered_map<std::string, size_t> index{};
+    for (size_t i = 0; i < switches.size(); ++i) {
+        index.emplace(switches[i].name, i);
+    }
+    return index;
+}
+
+yloc_status_t yloc::parse_topology_conf(std::istream &input, std::vector<slurm_switch> &switches)
+{
+    auto index = switch_index(switches);
+    std::string line;
+    size_t line_number = 0;
+    while (read_line(input, line, line_number)) {
+        std::istringstream tokens{line};
+        std::string token;
+        slurm_switch entry{};
+        bool valid = true;
+        while (tokens >> token && valid) {
+            size_t eq = token.find('=');
+            std::string_view key = std::string_view{token}.substr(0, eq);
+            std::string_view value = eq == std::string::npos ? std::string_view{} : std::string_view{token}.substr(eq + 1);
+            if (iequals(key, "SwitchName")) {
+                entry.name = value;
+            } else if (iequals(key, "Switches")) {
+                valid = expand_hostlist(value, entry.switches);
+            } else if (iequals(key, "Nodes")) {
+                valid = expand_hostlist(value, entry.nodes);
+            } else if (iequals(key, "LinkSpeed")) {
+                uint64_t link_speed;
+                valid = parse_number(value, link_speed);
+                entry.link_speed = link_speed;
+            }
+        }
+        if (!valid) {
+            std::cerr << "invalid topology.conf entry in line " << line_number << ": " << line << '\n';
+            return YLOC_STATUS_INVALID_ARGS;
+        }
+        if (entry.name.empty()) {
+            continue;
+        }
+
+        slurm_switch &sw = find_switch(switches, index, entry.name);
+        sw.switches.insert(sw.switches.end(), entry.switches.begin(), entry.switches.end());
+        sw.nodes.insert(sw.nodes.end(), entry.nodes.begin(), entry.nodes.end());
+        if (entry.link_speed.has_value()) {
+            sw.link_speed = entry.link_speed;
+        }
+    }
+    return YLOC_STATUS_SUCCESS;
+}
+
+yloc_status_t yloc::parse_switch_map(std::istream &input, std::vector<slurm_switch> &switches)
+{
+    auto index = switch_index(switches);
+    std::string line;
+    size_t line_number = 0;
+    while (read_line(input, line, line_number)) {
+        std::istringstream tokens{line};
+        std::string hostlist, name;
+        if (!(tokens >> hostlist)) {
+            continue;
+        }
+        std::vector<std::string> nodes{};
+        if (!(tokens >> name) || !expand_hostlist(hostlist, nodes)) {
+            std::cerr << "invalid switch map entry in line " << line_number << ": " << line << '\n';
+            return YLOC_STATUS_INVALID_ARGS;
+        }
+        slurm_switch &sw = find_switch(switches, index, name);
+        sw.nodes.insert(sw.nodes.end(), nodes.begin(), nodes.end());
+    }
+    return YLOC_STATUS_SUCCESS;
+}
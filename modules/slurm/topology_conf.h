@@ -0,0 +1,43 @@
+#pragma once
+
+#include <yloc/status.h>
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yloc
+{
+    /** @brief A switch of a Slurm topology.conf (topology/tree plugin). */
+    struct slurm_switch {
+        std::string name;
+        std::vector<std::string> switches{}; // child switches
+        std::vector<std::string> nodes{};    // attached compute nodes
+        std::optional<uint64_t> link_speed{};
+    };
+
+    /**
+     * @brief Expands a Slurm hostlist expression, e.g. "n[01-03,7],login" to n01 n02 n03 n7 login.
+     *
+     * Several bracket expressions per name are supported, zero-padding follows the lower bound.
+     *
+     * @return false if the expression is malformed
+     */
+    bool expand_hostlist(std::string_view expression, std::vector<std::string> &hostnames);
+
+    /**
+     * @brief Parses SwitchName lines with Switches=, Nodes= and LinkSpeed= of a topology.conf.
+     *
+     * Keys are case-insensitive, "#" starts a comment and a trailing "\" continues a line.
+     * Unknown keys are ignored.
+     */
+    yloc_status_t parse_topology_conf(std::istream &input, std::vector<slurm_switch> &switches);
+
+    /**
+     * @brief Parses "<hostlist> <switch>" lines and adds the nodes to the (new) switches.
+     */
+    yloc_status_t parse_switch_map(std::istream &input, std::vector<slurm_switch> &switches);
+}
@@ -0,0 +1,204 @@
+#include <yloc/change_feed.h>
+#include <yloc/sampling.h>
+
+#include <chrono>
+
+namespace yloc
+{
+    static void put_varint(std::string &buffer, uint64_t value)
+    {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    static bool get_varint(const char *&data, const char *end, uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; data < end && shift < 64; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*data++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    ChangeFeed::ChangeFeed(const Graph &g, std::ostream &out, feed_format format, uint64_t keyframe_interval)
+        : m_out{out}, m_format{format}, m_keyframe_interval{keyframe_interval > 0 ? keyframe_interval : 1}
+    {
+        for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+            if (const SampledAdapter *sampled = find_sampled_adapter(g[vd])) {
+                m_sources.emplace_back(vd, sampled);
+            }
+        }
+        m_last.resize(m_sources.size() * dynamic_properties().size());
+    }
+
+    size_t ChangeFeed::emit()
+    {
+        bool keyframe = m_sequence % m_keyframe_interval == 0;
+        size_t num_properties = dynamic_properties().size();
+        std::vector<change> changes{};
+        for (size_t s = 0; s < m_sources.size(); ++s) {
+            for (size_t i = 0; i < num_properties; ++i) {
+                auto latest = m_sources[s].second->latest(i);
+                auto &last = m_last[s * num_properties + i];
+                if (latest.has_value() && (keyframe || last != latest->value)) {
+                    changes.push_back({m_sources[s].first, i, latest->value, last.value_or(0)});
+                    last = latest->value;
+                }
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        if (m_format == feed_format::NDJSON) {
+            write_ndjson(keyframe, time, changes);
+        } else {
+            write_binary(keyframe, time, changes);
+        }
+        m_time = time;
+        ++m_sequence;
+        return changes.size();
+    }
+
+    void ChangeFeed::write_ndjson(bool keyframe, int64_t time, const std::vector<change> &changes)
+    {
+        std::string line = "{\"seq\":" + std::to_string(m_sequence) + ",\"time\":" + std::to_string(time) +
+                           ",\"keyframe\":" + (keyframe ? "true" : "false") + ",\"changes\":[";
+        for (size_t c = 0; c < changes.size(); ++c) {
+            line += c == 0 ? "{\"vertex\":" : ",{\"vertex\":";
+            line += std::to_string(changes[c].vd) + ",\"property\":\"";
+            line += dynamic_properties()[changes[c].property];
+            line += "\",\"value\":" + std::to_string(changes[c].value) + "}";
+        }
+        line += "]}\n";
+        m_out << line;
+        m_out.flush();
+    }
+
+    void ChangeFeed::write_binary(bool keyframe, int64_t time, const std::vector<change> &changes)
+    {
+        std::string payload{};
+        put_varint(payload, m_sequence);
+        payload.push_back(keyframe ? 1 : 0);
+        put_varint(payload, static_cast<uint64_t>(keyframe ? time : time - m_time));
+        if (keyframe) {
+            put_varint(payload, dynamic_properties().size());
+            for (auto name : dynamic_properties()) {
+                put_varint(payload, name.size());
+                payload.append(name);
+            }
+        }
+        put_varint(payload, changes.size());
+        vertex_descriptor_t previous_vd = 0;
+        for (const change &c : changes) {
+            put_varint(payload, c.vd - previous_vd);
+            put_varint(payload, c.property);
+            put_varint(payload, keyframe ? c.value : zigzag(static_cast<int64_t>(c.value - c.previous)));
+            previous_vd = c.vd;
+        }
+
+        std::string frame{};
+        put_varint(frame, payload.size());
+        m_out.write(frame.data(), frame.size());
+        m_out.write(payload.data(), payload.size());
+        m_out.flush();
+    }
+
+    size_t ChangeFeedDecoder::decode(const char *data, size_t size, std::optional<feed_frame> &frame)
+    {
+        frame.reset();
+        const char *p = data;
+        const char *end = data + size;
+        uint64_t payload_size;
+        if (!get_varint(p, end, payload_size) || static_cast<uint64_t>(end - p) < payload_size) {
+            return 0;
+        }
+        const char *payload_end = p + payload_size;
+        size_t consumed = payload_end - data;
+
+        // deltas after a lost or malformed frame would apply to stale values, so wait for the next keyframe
+        auto desynchronize = [&] {
+            m_synchronized = false;
+            m_values.clear();
+            return consumed;
+        };
+
+        feed_frame f{};
+        uint64_t time, count;
+        if (!get_varint(p, payload_end, f.sequence) || p == payload_end) {
+            return desynchronize();
+        }
+        f.keyframe = *p++ != 0;
+        if (!f.keyframe && (!m_synchronized || f.sequence != m_sequence)) {
+            return desynchronize();
+        }
+        if (!get_varint(p, payload_end, time)) {
+            return desynchronize();
+        }
+        f.time = f.keyframe ? static_cast<int64_t>(time) : m_time + static_cast<int64_t>(time);
+        if (f.keyframe) {
+            uint64_t num_properties, length;
+            if (!get_varint(p, payload_end, num_properties)) {
+                return desynchronize();
+            }
+            for (uint64_t i = 0; i < num_properties; ++i) {
+                if (!get_varint(p, payload_end, length) || static_cast<uint64_t>(payload_end - p) < length) {
+                    return desynchronize();
+                }
+                f.properties.emplace_back(p, length);
+                p += length;
+            }
+        }
+        if (!get_varint(p, payload_end, count)) {
+            return desynchronize();
+        }
+        // the whole frame is parsed before the tracked values are changed
+        vertex_descriptor_t vd = 0;
+        for (uint64_t c = 0; c < count; ++c) {
+            uint64_t vd_delta, property, value;
+            if (!get_varint(p, payload_end, vd_delta) || !get_varint(p, payload_end, property) || !get_varint(p, payload_end, value)) {
+                return desynchronize();
+            }
+            vd += vd_delta;
+            f.values.push_back({vd, {property, value}});
+        }
+
+        if (f.keyframe) {
+            m_values.clear();
+        }
+        for (auto &[vd, change] : f.values) {
+            if (vd >= m_values.size()) {
+                m_values.resize(vd + 1);
+            }
+            if (change.first >= m_values[vd].size()) {
+                m_values[vd].resize(change.first + 1);
+            }
+            auto &previous = m_values[vd][change.first];
+            if (!f.keyframe) {
+                change.second = previous.value_or(0) + static_cast<uint64_t>(unzigzag(change.second));
+            }
+            previous = change.second;
+        }
+        m_synchronized = true;
+        m_sequence = f.sequence + 1;
+        m_time = f.time;
+        frame = std::move(f);
+        return consumed;
+    }
+}
@@ -0,0 +1,63 @@
+#include <yloc/hostname_hierarchy.h>
+
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace yloc
+{
+    yloc_status_t make_hostname_hierarchy(Graph &g, const std::vector<std::string> &hostnames, const std::regex &pattern)
+    {
+        // hostnames of all ranks repeat for every process of a node
+        std::unordered_set<std::string_view> seen{};
+        seen.reserve(hostnames.size());
+
+        // vertex of every level seen so far, a level is attached to its parent when it is first seen
+        std::unordered_map<std::string, vertex_descriptor_t> levels{};
+
+        size_t matched = 0;
+        std::smatch match;
+        std::string name;
+        for (const auto &hostname : hostnames) {
+            if (!seen.insert(hostname).second || !std::regex_match(hostname, match, pattern)) {
+                continue;
+            }
+            ++matched;
+
+            name.clear();
+            vertex_descriptor_t parent{};
+            for (size_t i = 1; i < match.size(); ++i) {
+                // '/' cannot occur in hostnames, so captures of variable width do not run into each other
+                if (i > 1) {
+                    name += '/';
+                }
+                name += match.str(i);
+                auto [iter, first_seen] = levels.try_emplace(name);
+                if (first_seen) {
+                    iter->second = g.add_vertex("system:" + name);
+                    if (g[iter->second].type == UnknownComponentType::ptr()) {
+                        g[iter->second].type = Misc::ptr(); /** TODO: add component type for (logical) system interconnect components */
+                        g[iter->second].m_description = name;
+                    }
+                    if (i > 1) {
+                        g.add_relation(parent, iter->second);
+                    }
+                }
+                parent = iter->second;
+            }
+
+            vertex_descriptor_t machine_vd = g.add_vertex("machine:" + hostname);
+            if (g[machine_vd].type == UnknownComponentType::ptr()) {
+                g[machine_vd].type = Node::ptr();
+            }
+            if (g[machine_vd].m_description.empty()) {
+                g[machine_vd].m_description = hostname;
+            }
+            if (match.size() > 1) {
+                g.add_relation(parent, machine_vd);
+            }
+        }
+
+        return matched > 0 ? YLOC_STATUS_SUCCESS : YLOC_STATUS_NOT_FOUND;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <yloc/graph.h>
+#include <yloc/worker_pool.h>
+
+namespace yloc
+{
+    struct property_request {
+        vertex_descriptor_t vd;
+        std::string property;
+    };
+
+    /**
+     * @brief Reads the properties of all requests in parallel, so a call costs the slowest read instead of their sum.
+     *
+     * Waits until all reads are done or deadline. Reads that are late keep running on the
+     * workers (see async_workers()), but their values are discarded. The graph must not be
+     * modified until they are done.
+     *
+     * @return The values in order of requests, std::nullopt for missing properties and late reads
+     */
+    template <class RT>
+    std::vector<std::optional<RT>> get_all(const Graph &g, const std::vector<property_request> &requests, std::chrono::steady_clock::time_point deadline)
+    {
+        struct state {
+            std::mutex mutex{};
+            std::condition_variable cv{};
+            std::vector<std::optional<RT>> values;
+            size_t remaining;
+        };
+        auto shared = std::make_shared<state>();
+        shared->values.resize(requests.size());
+        shared->remaining = requests.size();
+
+        for (size_t i = 0; i < requests.size(); ++i) {
+            async_workers().submit([&g, request = requests[i], i, deadline, shared] {
+                std::optional<RT> value{};
+                if (std::chrono::steady_clock::now() < deadline) {
+                    value = g[request.vd].template get<RT>(request.property);
+                }
+                std::lock_guard<std::mutex> lock{shared->mutex};
+                shared->values[i] = std::move(value);
+                if (--shared->remaining == 0) {
+                    shared->cv.notify_one();
+                }
+            });
+        }
+
+        std::unique_lock<std::mutex> lock{shared->mutex};
+        shared->cv.wait_until(lock, deadline, [&] { return shared->remaining == 0; });
+        return shared->values;
+    }
+
+    /**
+     * @brief Reads the properties of all requests in parallel and calls callback(index, value) as each read completes.
+     *
+     * The callback runs on a worker thread. Reads that cannot start before deadline are
+     * completed with std::nullopt without calling the adapters.
+     */
+    template <class RT, class F>
+    void get_all_async(const Graph &g, const std::vector<property_request> &requests, std::chrono::steady_clock::time_point deadline, F callback)
+    {
+        auto shared_callback = std::make_shared<F>(std::move(callback));
+        for (size_t i = 0; i < requests.size(); ++i) {
+            async_workers().submit([&g, request = requests[i], i, deadline, shared_callback] {
+                std::optional<RT> value{};
+                if (std::chrono::steady_clock::now() < deadline) {
+                    value = g[request.vd].template get<RT>(request.property);
+                }
+                (*shared_callback)(i, std::move(value));
+            });
+        }
+    }
+}
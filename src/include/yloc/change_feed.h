@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <yloc/graph.h>
+
+namespace yloc
+{
+    class SampledAdapter;
+
+    enum class feed_format : int {
+        NDJSON = 0, /**< one JSON object per frame and line */
+        BINARY      /**< length-prefixed frames of varints, values delta-encoded */
+    };
+
+    /**
+     * @brief Exports the sampled properties of a graph as a stream of changes (YLOC_ONGOING).
+     *
+     * Every emit() writes one frame with a sequence number and the values that changed since
+     * the previous frame. Every keyframe_interval frames, a keyframe holds all values, so that
+     * consumers can start or resynchronize at any keyframe.
+     *
+     * NDJSON frames look like
+     *   {"seq":7,"time":1234,"keyframe":false,"changes":[{"vertex":12,"property":"power","value":70125}]}
+     *
+     * Binary frames are [varint size][payload], the payload is
+     *   varint seq, byte keyframe, varint time (keyframe: absolute, else delta to the previous frame),
+     *   keyframe only: varint #properties and the property names (varint size, bytes),
+     *   varint #changes and per change: varint vertex delta, varint property index,
+     *   value (keyframe: varint, else zigzag varint of the difference to the previous value).
+     * Changes are sorted by vertex and property, time is in nanoseconds of std::chrono::steady_clock.
+     */
+    class ChangeFeed
+    {
+    public:
+        ChangeFeed(const Graph &g, std::ostream &out, feed_format format, uint64_t keyframe_interval = 60);
+
+        /**
+         * @brief Writes a frame with the values that changed since the last frame.
+         *
+         * @return Number of values in the frame
+         */
+        size_t emit();
+
+        uint64_t sequence() const { return m_sequence; }
+
+    private:
+        struct change {
+            vertex_descriptor_t vd;
+            size_t property;
+            uint64_t value;
+            uint64_t previous;
+        };
+
+        void write_ndjson(bool keyframe, int64_t time, const std::vector<change> &changes);
+        void write_binary(bool keyframe, int64_t time, const std::vector<change> &changes);
+
+        std::ostream &m_out;
+        feed_format m_format;
+        uint64_t m_keyframe_interval;
+        uint64_t m_sequence{0};
+        int64_t m_time{0};
+        std::vector<std::pair<vertex_descriptor_t, const SampledAdapter *>> m_sources{};
+        std::vector<std::optional<uint64_t>> m_last{}; // by source and property
+    };
+
+    /**
+     * @brief A decoded frame of a binary change feed.
+     */
+    struct feed_frame {
+        uint64_t sequence;
+        bool keyframe;
+        int64_t time;
+        std::vector<std::string> properties; // names of the property indices, keyframes only
+        std::vector<std::pair<vertex_descriptor_t, std::pair<size_t, uint64_t>>> values; // vertex, property index and value
+    };
+
+    /**
+     * @brief Decodes a binary change feed, previous values are tracked from a keyframe on.
+     */
+    class ChangeFeedDecoder
+    {
+    public:
+        /**
+         * @brief Decodes the frame at the beginning of data.
+         *
+         * Frames before the first keyframe are skipped, since their values are differences. After a
+         * gap in the sequence numbers or a malformed frame, frames are skipped until the next keyframe.
+         *
+         * @return Number of bytes consumed, 0 if data does not hold a complete frame
+         */
+        size_t decode(const char *data, size_t size, std::optional<feed_frame> &frame);
+
+    private:
+        bool m_synchronized{false};
+        uint64_t m_sequence{0}; // expected sequence number of the next frame
+        int64_t m_time{0};
+        std::vector<std::vector<std::optional<uint64_t>>> m_values{}; // by vertex and property
+    };
+}
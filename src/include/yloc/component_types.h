@@ -16,21 +16,27 @@
 /** TODO: Add more IO-Devices and Link-types (PCIe, USB, InfiniBand ?) */
 /** TODO: Fox multiple inheritance from non-virtual base class */
 
+#include <string_view>
+#include <unordered_map>
+
 /** @brief Helper macro for type declaration. */
-#define YLOC_DECLARE_TYPE(type_name, ...)              \
-    class type_name : virtual public __VA_ARGS__       \
-    {                                                  \
-    public:                                            \
-        virtual ~type_name() = default;                \
-        inline static const type_name *ptr()           \
-        {                                              \
-            static const type_name s;                  \
-            return &s;                                 \
-        }                                              \
-        virtual const char *to_string() const override \
-        {                                              \
-            return #type_name;                         \
-        }                                              \
+#define YLOC_DECLARE_TYPE(type_name, ...)                                                       \
+    class type_name : virtual public __VA_ARGS__                                                \
+    {                                                                                           \
+    public:                                                                                     \
+        virtual ~type_name() = default;                                                         \
+        inline static const type_name *ptr()                                                    \
+        {                                                                                       \
+            static const type_name s;                                                           \
+            return &s;                                                                          \
+        }                                                                                       \
+        virtual const char *to_string() const override                                          \
+        {                                                                                       \
+            return #type_name;                                                                  \
+        }                                                                                       \
+                                                                                                \
+    private:                                                                                    \
+        inline static const bool s_registered = register_component_type<type_name>(#type_name); \
     };
 
 namespace yloc
@@ -53,6 +59,36 @@ namespace yloc
         }
     };
 
+    /**
+     * @brief Registry of all declared component types by name.
+     *
+     * Used to restore component types of serialized graphs, e.g. shared memory snapshots.
+     */
+    inline std::unordered_map<std::string_view, const Component *(*)()> &component_type_registry()
+    {
+        static std::unordered_map<std::string_view, const Component *(*)()> registry{};
+        return registry;
+    }
+
+    template <class ComponentType>
+    inline bool register_component_type(std::string_view name)
+    {
+        component_type_registry()[name] = []() -> const Component * { return ComponentType::ptr(); };
+        return true;
+    }
+
+    /**
+     * @brief Returns the component type with the given name or nullptr if there is no such type.
+     */
+    inline const Component *component_type(std::string_view name)
+    {
+        auto iter = component_type_registry().find(name);
+        if (iter == component_type_registry().end()) {
+            return nullptr;
+        }
+        return iter->second();
+    }
+
     /***********************************
      * List of component types
      ***********************************/
@@ -84,6 +120,11 @@ namespace yloc
     YLOC_DECLARE_TYPE(VolatileMemory, Memory)
     YLOC_DECLARE_TYPE(NonVolatileMemory, Memory)
 
+    /** @brief On-package high bandwidth memory, e.g. HBM or MCDRAM. */
+    YLOC_DECLARE_TYPE(HighBandwidthMemory, VolatileMemory)
+    /** @brief Memory attached through an expansion link, e.g. CXL memory expanders. */
+    YLOC_DECLARE_TYPE(ExpansionMemory, VolatileMemory)
+
     YLOC_DECLARE_TYPE(DataCache, Cache)
     YLOC_DECLARE_TYPE(InstructionCache, Cache)
     YLOC_DECLARE_TYPE(UnifiedCache, DataCache, InstructionCache)
@@ -146,6 +187,13 @@ namespace yloc
     // YLOC_DECLARE_TYPE(NetworkInterconnect, Link)
     YLOC_DECLARE_TYPE(Bus, Link)
 
+    /***********************************
+     * Network-Components
+     ***********************************/
+
+    /** @brief Switch of the system interconnect, e.g. from a Slurm topology.conf. */
+    YLOC_DECLARE_TYPE(Switch, Component)
+
     /***********************************
      * Miscellaneous
      ***********************************/
@@ -1,8 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include <boost/graph/adjacency_iterator.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
 #include <yloc/edge.h>
 #include <yloc/vertex.h>
@@ -10,6 +24,10 @@
 
 namespace yloc
 {
+    /**
+     * The boost graph only stores relations outside the hierarchy (e.g. GPU_INTERCONNECT), the
+     * hierarchy is stored as parent index and children array per vertex (see Graph).
+     */
     using boost_graph_t = boost::adjacency_list<
         boost::vecS,           // out-edge list container selector
         boost::vecS,           // vertex list container selector
@@ -17,14 +35,291 @@ namespace yloc
         Vertex,                // bundled vertex property
         Edge>;                 // bundled edge property
 
-    using edge_descriptor_t = typename boost::graph_traits<boost_graph_t>::edge_descriptor;
     using vertex_descriptor_t = typename boost::graph_traits<boost_graph_t>::vertex_descriptor;
 
+    /**
+     * @brief Edge of the graph, either an edge of the boost graph or a virtual PARENT/CHILD edge of the hierarchy.
+     */
+    struct edge_descriptor_t {
+        edge_descriptor_t() = default;
+
+        edge_descriptor_t(vertex_descriptor_t source, vertex_descriptor_t target, const Edge *property)
+            : m_source{source}, m_target{target}, m_property{property} {}
+
+        explicit edge_descriptor_t(const typename boost::graph_traits<boost_graph_t>::edge_descriptor &e)
+            : m_source{e.m_source}, m_target{e.m_target}, m_property{static_cast<const Edge *>(e.get_property())} {}
+
+        bool operator==(const edge_descriptor_t &other) const
+        {
+            return m_source == other.m_source && m_target == other.m_target && m_property == other.m_property;
+        }
+
+        bool operator!=(const edge_descriptor_t &other) const { return !(*this == other); }
+
+        vertex_descriptor_t m_source{};
+        vertex_descriptor_t m_target{};
+        const Edge *m_property{};
+    };
+
+    /**
+     * @brief Dense matrix of pairwise values between a set of vertices.
+     *
+     * Used for data that does not fit the hierarchy, e.g. NUMA latency or bandwidth
+     * matrices. The value in row i and column j is the value from vertex i to vertex j.
+     */
+    class DistanceTable
+    {
+    public:
+        /** @brief Whether smaller (latency) or larger (bandwidth) values are better. */
+        enum class kind : int { LATENCY,
+                                BANDWIDTH };
+
+        DistanceTable() = default;
+
+        DistanceTable(kind k, std::vector<vertex_descriptor_t> vertices)
+            : m_kind{k}, m_vertices{std::move(vertices)}, m_values(m_vertices.size() * m_vertices.size(), s_unknown) {}
+
+        kind get_kind() const noexcept { return m_kind; }
+
+        const std::vector<vertex_descriptor_t> &vertices() const noexcept { return m_vertices; }
+
+        /**
+         * @brief Returns the row/column index of vertex vd or std::nullopt if vd is not part of the table.
+         */
+        std::optional<size_t> index(vertex_descriptor_t vd) const
+        {
+            for (size_t i = 0; i < m_vertices.size(); ++i) {
+                if (m_vertices[i] == vd) {
+                    return i;
+                }
+            }
+            return {};
+        }
+
+        void set(size_t from, size_t to, uint64_t value) { m_values[from * m_vertices.size() + to] = value; }
+
+        std::optional<uint64_t> value(size_t from, size_t to) const
+        {
+            uint64_t value = m_values[from * m_vertices.size() + to];
+            if (value == s_unknown) {
+                return {};
+            }
+            return value;
+        }
+
+        /**
+         * @brief Returns true if value a is closer than value b with respect to the kind of the table.
+         */
+        bool is_closer(uint64_t a, uint64_t b) const { return m_kind == kind::LATENCY ? a < b : a > b; }
+
+    private:
+        static constexpr uint64_t s_unknown = std::numeric_limits<uint64_t>::max();
+
+        kind m_kind{kind::LATENCY};
+        std::vector<vertex_descriptor_t> m_vertices{};
+        std::vector<uint64_t> m_values{};
+    };
+
+    class Graph;
+    class TemplateInstance;
+
+    /**
+     * @brief Compact placement of all MPI ranks of a job on compute nodes.
+     *
+     * Ranks are stored as runs of consecutive ranks on the same node, so a block placement takes
+     * one entry per node. Vertices of processes that are not part of the graph (remote ranks in
+     * partitioned mode) are materialized on demand through a callback of the MPI module.
+     */
+    class ProcessMap
+    {
+    public:
+        /** @brief Position of a rank: its node and its index among the ranks of that node. */
+        struct location {
+            int node;
+            int local_index;
+        };
+
+        /** @brief Consecutive ranks placed on the same node. */
+        struct run {
+            int first_rank;
+            int count;
+            int node;
+            int first_local_index;
+        };
+
+        using materializer_t = std::function<vertex_descriptor_t(Graph &, int)>;
+
+        ProcessMap() = default;
+
+        /**
+         * @param runs Runs sorted by first rank that cover all ranks
+         * @param hostnames Hostname of every node
+         * @param local_node Node of the calling process
+         */
+        ProcessMap(std::vector<run> runs, std::vector<std::string> hostnames, int local_node)
+            : m_runs{std::move(runs)}, m_hostnames{std::move(hostnames)}, m_local_node{local_node} {}
+
+        int size() const { return m_runs.empty() ? 0 : m_runs.back().first_rank + m_runs.back().count; }
+
+        int num_nodes() const { return static_cast<int>(m_hostnames.size()); }
+
+        int local_node() const noexcept { return m_local_node; }
+
+        const std::string &hostname(int node) const { return m_hostnames[node]; }
+
+        const std::vector<run> &runs() const noexcept { return m_runs; }
+
+        /**
+         * @brief Returns the location of rank or std::nullopt if rank is not part of the job.
+         */
+        std::optional<location> locate(int rank) const
+        {
+            auto iter = std::upper_bound(m_runs.begin(), m_runs.end(), rank, [](int r, const run &x) { return r < x.first_rank; });
+            if (iter == m_runs.begin() || rank >= (--iter)->first_rank + iter->count) {
+                return {};
+            }
+            return location{iter->node, iter->first_local_index + rank - iter->first_rank};
+        }
+
+        bool is_local(int rank) const
+        {
+            auto loc = locate(rank);
+            return loc.has_value() && loc->node == m_local_node;
+        }
+
+        void set_vertex(int rank, vertex_descriptor_t vd) { m_vertices[rank] = vd; }
+
+        void set_materializer(materializer_t materializer) { m_materializer = std::move(materializer); }
+
+        /**
+         * @brief Returns the vertex of the process with rank, adding it to graph g if necessary.
+         */
+        std::optional<vertex_descriptor_t> vertex(Graph &g, int rank)
+        {
+            auto iter = m_vertices.find(rank);
+            if (iter != m_vertices.end()) {
+                return iter->second;
+            }
+            if (!m_materializer || !locate(rank).has_value()) {
+                return {};
+            }
+            vertex_descriptor_t vd = m_materializer(g, rank);
+            m_vertices[rank] = vd;
+            return vd;
+        }
+
+    private:
+        std::vector<run> m_runs{};
+        std::vector<std::string> m_hostnames{};
+        int m_local_node{};
+        std::unordered_map<int, vertex_descriptor_t> m_vertices{};
+        materializer_t m_materializer{};
+    };
+
+    /**
+     * @brief The yloc graph.
+     *
+     * Hierarchy relations (most of the graph) are not stored as edges but as parent index and
+     * children array per vertex. They are served as virtual PARENT and CHILD edges by out_edges(),
+     * in_edges() and edges(), so boost graph algorithms see the same graph as with stored edges.
+     */
     class Graph : public boost_graph_t
     {
+        /* iterates the virtual hierarchy edges of a vertex first, then its stored edges */
+        template <bool Out>
+        class incident_edge_iterator
+            : public boost::iterator_facade<incident_edge_iterator<Out>, edge_descriptor_t, std::forward_iterator_tag, edge_descriptor_t>
+        {
+            using stored_iterator = std::conditional_t<Out, typename boost_graph_t::out_edge_iterator, typename boost_graph_t::in_edge_iterator>;
+
+        public:
+            incident_edge_iterator() = default;
+
+            incident_edge_iterator(const Graph *g, vertex_descriptor_t v, size_t index, stored_iterator stored)
+                : m_g{g}, m_v{v}, m_index{index}, m_stored{stored} {}
+
+        private:
+            friend class boost::iterator_core_access;
+
+            edge_descriptor_t dereference() const
+            {
+                if (m_index < m_g->num_hierarchy_edges(m_v)) {
+                    return m_g->hierarchy_edge(m_v, m_index, Out);
+                }
+                return edge_descriptor_t{*m_stored};
+            }
+
+            void increment()
+            {
+                if (m_index < m_g->num_hierarchy_edges(m_v)) {
+                    ++m_index;
+                } else {
+                    ++m_stored;
+                }
+            }
+
+            bool equal(const incident_edge_iterator &other) const { return m_index == other.m_index && m_stored == other.m_stored; }
+
+            const Graph *m_g{};
+            vertex_descriptor_t m_v{};
+            size_t m_index{};
+            stored_iterator m_stored{};
+        };
+
+        /* iterates the out-edges of all vertices */
+        class all_edge_iterator
+            : public boost::iterator_facade<all_edge_iterator, edge_descriptor_t, std::forward_iterator_tag, edge_descriptor_t>
+        {
+        public:
+            all_edge_iterator() = default;
+
+            all_edge_iterator(const Graph *g, vertex_descriptor_t v) : m_g{g}, m_v{v}
+            {
+                if (m_v < boost::num_vertices(*m_g)) {
+                    std::tie(m_edge, m_end) = m_g->out_edge_range(m_v);
+                    skip_empty();
+                }
+            }
+
+        private:
+            friend class boost::iterator_core_access;
+
+            edge_descriptor_t dereference() const { return *m_edge; }
+
+            void increment()
+            {
+                ++m_edge;
+                skip_empty();
+            }
+
+            void skip_empty()
+            {
+                while (m_edge == m_end && ++m_v < boost::num_vertices(*m_g)) {
+                    std::tie(m_edge, m_end) = m_g->out_edge_range(m_v);
+                }
+            }
+
+            bool equal(const all_edge_iterator &other) const
+            {
+                return m_v == other.m_v && (m_v >= boost::num_vertices(*m_g) || m_edge == other.m_edge);
+            }
+
+            const Graph *m_g{};
+            vertex_descriptor_t m_v{};
+            incident_edge_iterator<true> m_edge{}, m_end{};
+        };
+
     public:
         using identifier_t = std::string;
 
+        // graph traits with virtual hierarchy edges, they hide those of the boost graph
+        using edge_descriptor = edge_descriptor_t;
+        using out_edge_iterator = incident_edge_iterator<true>;
+        using in_edge_iterator = incident_edge_iterator<false>;
+        using edge_iterator = all_edge_iterator;
+        using adjacency_iterator = typename boost::adjacency_iterator_generator<Graph, vertex_descriptor_t, out_edge_iterator>::type;
+        using inv_adjacency_iterator = typename boost::inv_adjacency_iterator_generator<Graph, vertex_descriptor_t, in_edge_iterator>::type;
+
         Graph() = default;
 
     private:
@@ -68,6 +363,158 @@ namespace yloc
             return vd;
         }
 
+        /**
+         * @brief Adds a relation between two vertices unless it already exists.
+         *
+         * edge_type::CHILD makes child a child of parent, that is a CHILD edge from parent to
+         * child and a PARENT edge back (edge_type::PARENT swaps the roles). The first parent of a
+         * vertex is stored in the hierarchy arrays, further parents (e.g. a machine below a
+         * switch and a rack) as edges. Other kinds, e.g. GPU_INTERCONNECT, are symmetric and add
+         * an edge of that kind in both directions. Duplicates are detected in constant time.
+         *
+         * @return true if the relation was added, false if it already existed
+         */
+        bool add_relation(vertex_descriptor_t parent, vertex_descriptor_t child, edge_type kind = edge_type::CHILD)
+        {
+            if (kind == edge_type::PARENT) {
+                return add_relation(child, parent, edge_type::CHILD);
+            }
+            if (kind == edge_type::CHILD) {
+                reserve_hierarchy(std::max(parent, child));
+                if (m_parents[child] == parent) {
+                    return false;
+                }
+                if (m_parents[child] == s_no_parent) {
+                    m_parents[child] = parent;
+                    m_children[parent].push_back(child);
+                    ++m_num_hierarchy_links;
+                    return true;
+                }
+            }
+            if (!m_relations[static_cast<int>(kind)].insert(relation_key(parent, child, kind)).second) {
+                return false;
+            }
+            boost::add_edge(parent, child, Edge{kind}, base());
+            boost::add_edge(child, parent, Edge{kind == edge_type::CHILD ? edge_type::PARENT : kind}, base());
+            return true;
+        }
+
+        /**
+         * @brief Removes a relation added by add_relation().
+         *
+         * If the first parent of child is removed, a further parent (if any) takes its place.
+         *
+         * @return true if the relation existed
+         */
+        bool remove_relation(vertex_descriptor_t parent, vertex_descriptor_t child, edge_type kind = edge_type::CHILD)
+        {
+            if (kind == edge_type::PARENT) {
+                return remove_relation(child, parent, edge_type::CHILD);
+            }
+            if (kind == edge_type::CHILD && child < m_parents.size() && m_parents[child] == parent) {
+                unlink_parent(child);
+                promote_parent(child);
+                return true;
+            }
+            if (m_relations[static_cast<int>(kind)].erase(relation_key(parent, child, kind)) == 0) {
+                return false;
+            }
+            edge_type back = kind == edge_type::CHILD ? edge_type::PARENT : kind;
+            boost::remove_out_edge_if(parent, [&](auto e) { return e.m_target == child && base()[e].type == kind; }, base());
+            boost::remove_out_edge_if(child, [&](auto e) { return e.m_target == parent && base()[e].type == back; }, base());
+            return true;
+        }
+
+        bool has_relation(vertex_descriptor_t parent, vertex_descriptor_t child, edge_type kind = edge_type::CHILD) const
+        {
+            if (kind == edge_type::PARENT) {
+                return has_relation(child, parent, edge_type::CHILD);
+            }
+            if (kind == edge_type::CHILD && child < m_parents.size() && m_parents[child] == parent) {
+                return true;
+            }
+            return m_relations[static_cast<int>(kind)].count(relation_key(parent, child, kind)) != 0;
+        }
+
+        /**
+         * @brief Removes all relations and edges of vertex vd, the vertex itself stays in the graph.
+         */
+        void clear_vertex(vertex_descriptor_t vd)
+        {
+            if (vd < m_parents.size()) {
+                if (m_parents[vd] != s_no_parent) {
+                    unlink_parent(vd);
+                }
+                std::vector<vertex_descriptor_t> children{};
+                children.swap(m_children[vd]);
+                m_num_hierarchy_links -= children.size();
+                for (auto child : children) {
+                    m_parents[child] = s_no_parent;
+                    promote_parent(child);
+                }
+            }
+
+            for (auto e : boost::make_iterator_range(boost::out_edges(vd, base()))) {
+                edge_type kind = base()[e].type;
+                if (kind == edge_type::PARENT) {
+                    m_relations[static_cast<int>(edge_type::CHILD)].erase(relation_key(e.m_target, vd, edge_type::CHILD));
+                } else {
+                    m_relations[static_cast<int>(kind)].erase(relation_key(vd, e.m_target, kind));
+                }
+            }
+            boost::clear_vertex(vd, base());
+        }
+
+        /**
+         * @brief Returns the (first) parent of vertex vd in the hierarchy.
+         */
+        std::optional<vertex_descriptor_t> parent(vertex_descriptor_t vd) const
+        {
+            if (vd >= m_parents.size() || m_parents[vd] == s_no_parent) {
+                return {};
+            }
+            return m_parents[vd];
+        }
+
+        /**
+         * @brief Returns the children of vertex vd in the hierarchy (without children of further parents).
+         */
+        const std::vector<vertex_descriptor_t> &children(vertex_descriptor_t vd) const
+        {
+            static const std::vector<vertex_descriptor_t> none{};
+            return vd < m_children.size() ? m_children[vd] : none;
+        }
+
+        /* ranges of the graph traits, see the boost overloads below */
+        std::pair<out_edge_iterator, out_edge_iterator> out_edge_range(vertex_descriptor_t v) const
+        {
+            auto stored = boost::out_edges(v, base());
+            return {out_edge_iterator{this, v, 0, stored.first}, out_edge_iterator{this, v, num_hierarchy_edges(v), stored.second}};
+        }
+
+        std::pair<in_edge_iterator, in_edge_iterator> in_edge_range(vertex_descriptor_t v) const
+        {
+            auto stored = boost::in_edges(v, base());
+            return {in_edge_iterator{this, v, 0, stored.first}, in_edge_iterator{this, v, num_hierarchy_edges(v), stored.second}};
+        }
+
+        std::pair<edge_iterator, edge_iterator> edge_range() const
+        {
+            return {edge_iterator{this, 0}, edge_iterator{this, boost::num_vertices(base())}};
+        }
+
+        /** @brief Number of virtual hierarchy edges of vertex v in each direction. */
+        size_t num_hierarchy_edges(vertex_descriptor_t v) const
+        {
+            if (v >= m_parents.size()) {
+                return 0;
+            }
+            return (m_parents[v] != s_no_parent) + m_children[v].size();
+        }
+
+        /** @brief Number of all edges, two per hierarchy relation. */
+        size_t num_all_edges() const { return 2 * m_num_hierarchy_links + boost::num_edges(base()); }
+
         /**
          * @brief Provides access to vertices of the underlying boost graph.
          */
@@ -93,23 +540,157 @@ namespace yloc
             return (*this)[m_identifier_map[id]];
         }
 
-        auto &operator[](edge_descriptor_t ed)
+        /**
+         * @brief Provides access to the properties of (virtual) edges, they cannot be modified.
+         */
+        const Edge &operator[](edge_descriptor_t ed) const
         {
-            return this->boost_graph_t::operator[](ed);
+            return *ed.m_property;
         }
 
-        const auto &operator[](edge_descriptor_t ed) const
-        {
-            return this->boost_graph_t::operator[](ed);
-        }
+        /**
+         * @brief Returns the mapping of identifiers (e.g. "machine:<hostname>") to vertices.
+         */
+        const std::unordered_map<identifier_t, vertex_descriptor_t> &identifier_map() const noexcept { return m_identifier_map; }
 
         void set_root_vertex(vertex_descriptor_t vertex) noexcept { m_root_vertex = vertex; }
 
         vertex_descriptor_t get_root_vertex() const noexcept { return m_root_vertex; }
 
+        /**
+         * @brief Adds or replaces the distance table with the given name, e.g. "numa_latency".
+         */
+        void set_distance_table(const std::string &name, DistanceTable table) { m_distance_tables[name] = std::move(table); }
+
+        void remove_distance_table(const std::string &name) { m_distance_tables.erase(name); }
+
+        const std::unordered_map<std::string, DistanceTable> &distance_tables() const noexcept { return m_distance_tables; }
+
+        /**
+         * @brief Returns the distance table with the given name or nullptr if there is none.
+         */
+        const DistanceTable *distance_table(const std::string &name) const
+        {
+            auto iter = m_distance_tables.find(name);
+            if (iter == m_distance_tables.end()) {
+                return nullptr;
+            }
+            return &iter->second;
+        }
+
+        /**
+         * @brief Sets the index of logical cores by efficiency class.
+         *
+         * @param cpu_kinds Logical cores per efficiency class, index 0 holds the most energy-efficient cores
+         */
+        void set_cpu_kinds(std::vector<std::vector<vertex_descriptor_t>> cpu_kinds) { m_cpu_kinds = std::move(cpu_kinds); }
+
+        /**
+         * @brief Returns the logical cores by efficiency class, empty if the cpu kinds are unknown.
+         */
+        const std::vector<std::vector<vertex_descriptor_t>> &cpu_kinds() const noexcept { return m_cpu_kinds; }
+
+        /**
+         * @brief Returns the placement of the MPI ranks, empty if the MPI module is not active.
+         */
+        ProcessMap &process_map() noexcept { return m_process_map; }
+
+        const ProcessMap &process_map() const noexcept { return m_process_map; }
+
+        void set_process_map(ProcessMap map) { m_process_map = std::move(map); }
+
+        /**
+         * @brief Lets vertex vd (e.g. a remote machine) reference a shared node template instead of its own subgraph.
+         *
+         * @see node_template.h
+         */
+        void set_template_instance(vertex_descriptor_t vd, std::shared_ptr<TemplateInstance> instance) { m_template_instances[vd] = std::move(instance); }
+
+        /**
+         * @brief Returns the template instance of vertex vd or nullptr if vd has its subgraph in this graph.
+         */
+        TemplateInstance *template_instance(vertex_descriptor_t vd) const
+        {
+            auto iter = m_template_instances.find(vd);
+            if (iter == m_template_instances.end()) {
+                return nullptr;
+            }
+            return iter->second.get();
+        }
+
+        void remove_template_instance(vertex_descriptor_t vd) { m_template_instances.erase(vd); }
+
     private:
+        static constexpr vertex_descriptor_t s_no_parent = std::numeric_limits<vertex_descriptor_t>::max();
+
+        inline static const Edge s_parent_edge{edge_type::PARENT};
+        inline static const Edge s_child_edge{edge_type::CHILD};
+
+        boost_graph_t &base() { return *this; }
+
+        const boost_graph_t &base() const { return *this; }
+
+        /* vertices may also be added by boost::add_vertex(), so the hierarchy arrays grow on demand */
+        void reserve_hierarchy(vertex_descriptor_t vd)
+        {
+            if (vd >= m_parents.size()) {
+                m_parents.resize(vd + 1, s_no_parent);
+                m_children.resize(vd + 1);
+            }
+        }
+
+        /* removes the link of child to its first parent from the hierarchy arrays */
+        void unlink_parent(vertex_descriptor_t child)
+        {
+            auto &siblings = m_children[m_parents[child]];
+            siblings.erase(std::find(siblings.begin(), siblings.end(), child));
+            m_parents[child] = s_no_parent;
+            --m_num_hierarchy_links;
+        }
+
+        /* moves a further parent of child, stored as edges, into the hierarchy arrays */
+        void promote_parent(vertex_descriptor_t child)
+        {
+            for (auto e : boost::make_iterator_range(boost::out_edges(child, base()))) {
+                if (base()[e].type == edge_type::PARENT) {
+                    vertex_descriptor_t parent = e.m_target;
+                    remove_relation(parent, child);
+                    add_relation(parent, child);
+                    return;
+                }
+            }
+        }
+
+        /* i-th virtual edge of v, the edge to the parent comes first */
+        edge_descriptor_t hierarchy_edge(vertex_descriptor_t v, size_t i, bool out) const
+        {
+            bool has_parent = m_parents[v] != s_no_parent;
+            if (has_parent && i == 0) {
+                return out ? edge_descriptor_t{v, m_parents[v], &s_parent_edge} : edge_descriptor_t{m_parents[v], v, &s_child_edge};
+            }
+            vertex_descriptor_t child = m_children[v][i - has_parent];
+            return out ? edge_descriptor_t{v, child, &s_child_edge} : edge_descriptor_t{child, v, &s_parent_edge};
+        }
+
+        /* vertex descriptors are packed into 32 bits each, symmetric relations are stored once */
+        static uint64_t relation_key(vertex_descriptor_t a, vertex_descriptor_t b, edge_type kind)
+        {
+            if (kind != edge_type::CHILD && b < a) {
+                std::swap(a, b);
+            }
+            return static_cast<uint64_t>(a) << 32 | static_cast<uint32_t>(b);
+        }
+
         std::unordered_map<identifier_t, vertex_descriptor_t> m_identifier_map{};
+        std::array<std::unordered_set<uint64_t>, static_cast<int>(edge_type::EDGE_TYPE_MAX)> m_relations{}; // relations stored as edges
+        std::vector<vertex_descriptor_t> m_parents{};
+        std::vector<std::vector<vertex_descriptor_t>> m_children{};
+        size_t m_num_hierarchy_links{0};
         vertex_descriptor_t m_root_vertex{};
+        std::unordered_map<std::string, DistanceTable> m_distance_tables{};
+        std::vector<std::vector<vertex_descriptor_t>> m_cpu_kinds{};
+        ProcessMap m_process_map{};
+        std::unordered_map<vertex_descriptor_t, std::shared_ptr<TemplateInstance>> m_template_instances{};
     };
 
     /**
@@ -119,3 +700,78 @@ namespace yloc
      */
     Graph &root_graph();
 }
+
+/*
+ * Graph traits of yloc::Graph including the virtual hierarchy edges. They are declared in
+ * namespace boost, so that qualified calls like boost::out_edges(v, g) and the unqualified calls
+ * of boost algorithms (found through the boost_graph_t base class) both resolve to them.
+ */
+namespace boost
+{
+    inline std::pair<yloc::Graph::out_edge_iterator, yloc::Graph::out_edge_iterator> out_edges(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        return g.out_edge_range(v);
+    }
+
+    inline std::pair<yloc::Graph::in_edge_iterator, yloc::Graph::in_edge_iterator> in_edges(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        return g.in_edge_range(v);
+    }
+
+    inline std::pair<yloc::Graph::edge_iterator, yloc::Graph::edge_iterator> edges(const yloc::Graph &g)
+    {
+        return g.edge_range();
+    }
+
+    inline size_t out_degree(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        return g.num_hierarchy_edges(v) + out_degree(v, static_cast<const yloc::boost_graph_t &>(g));
+    }
+
+    inline size_t in_degree(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        return g.num_hierarchy_edges(v) + in_degree(v, static_cast<const yloc::boost_graph_t &>(g));
+    }
+
+    inline size_t degree(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        return out_degree(v, g) + in_degree(v, g);
+    }
+
+    inline size_t num_edges(const yloc::Graph &g)
+    {
+        return g.num_all_edges();
+    }
+
+    inline yloc::vertex_descriptor_t source(const yloc::edge_descriptor_t &e, const yloc::Graph &)
+    {
+        return e.m_source;
+    }
+
+    inline yloc::vertex_descriptor_t target(const yloc::edge_descriptor_t &e, const yloc::Graph &)
+    {
+        return e.m_target;
+    }
+
+    inline std::pair<yloc::Graph::adjacency_iterator, yloc::Graph::adjacency_iterator> adjacent_vertices(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        auto range = g.out_edge_range(v);
+        return {yloc::Graph::adjacency_iterator{range.first, &g}, yloc::Graph::adjacency_iterator{range.second, &g}};
+    }
+
+    inline std::pair<yloc::Graph::inv_adjacency_iterator, yloc::Graph::inv_adjacency_iterator> inv_adjacent_vertices(yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        auto range = g.in_edge_range(v);
+        return {yloc::Graph::inv_adjacency_iterator{range.first, &g}, yloc::Graph::inv_adjacency_iterator{range.second, &g}};
+    }
+
+    inline std::pair<yloc::edge_descriptor_t, bool> edge(yloc::vertex_descriptor_t u, yloc::vertex_descriptor_t v, const yloc::Graph &g)
+    {
+        for (auto e : make_iterator_range(g.out_edge_range(u))) {
+            if (e.m_target == v) {
+                return {e, true};
+            }
+        }
+        return {yloc::edge_descriptor_t{}, false};
+    }
+}
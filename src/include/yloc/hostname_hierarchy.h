@@ -0,0 +1,29 @@
+#pragma once
+
+#include <yloc/graph.h>
+#include <yloc/status.h>
+
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace yloc
+{
+    /**
+     * @brief Hostname pattern of SuperMUC-NG (island, rack, chassis, e.g. i01r02c03s04).
+     */
+    inline constexpr const char *supermuc_hostname_pattern = "(i[0-9]{2})(r[0-9]{2})(c[0-9]{2})s[0-9]{2}";
+
+    /**
+     * @brief Adds the system hierarchy encoded in hostnames above the machine vertices.
+     *
+     * Every capture group of pattern is a level of the hierarchy, outermost first. A level is
+     * identified by its own and all outer groups joined by '/', e.g. "system:i01/r02" for the
+     * rack of i01r02c03s04, and the machine "machine:<hostname>" becomes a child of the
+     * innermost level. Duplicate hostnames are processed once, hostnames that do not match the
+     * pattern are ignored.
+     *
+     * @return YLOC_STATUS_NOT_FOUND if no hostname matches the pattern
+     */
+    yloc_status_t make_hostname_hierarchy(Graph &g, const std::vector<std::string> &hostnames, const std::regex &pattern);
+}
@@ -4,11 +4,29 @@
 
 #include <vector>
 
+/**
+ * @brief Flags to control the initialization of yloc.
+ */
+typedef enum : int {
+    YLOC_FULL = 0,             /**< the complete topology of the node */
+    YLOC_RESTRICT = 1 << 0,    /**< only cpus and memory nodes the process is allowed to use (cgroups, cpusets) */
+    YLOC_PARTITIONED = 1 << 1, /**< only MPI processes of the local node, other ranks are kept in Graph::process_map() */
+    YLOC_SHARED = 1 << 2,      /**< share the static part of the graph between the processes of a node, ignored with YLOC_BOUND */
+    YLOC_CLUSTER = 1 << 3,     /**< add the hardware of all machines of an MPI job below their machine vertices */
+    YLOC_ONGOING = 1 << 4,     /**< sample dynamic properties in background threads until finalize() */
+    YLOC_BOUND = 1 << 5,       /**< as YLOC_RESTRICT, further only cpus and memory nodes the process is bound to (e.g. per-rank binding) */
+} yloc_init_flags_t;
+
 namespace yloc
 {
-    yloc_status_t init();
+    yloc_status_t init(int flags = YLOC_FULL);
     yloc_status_t finalize();
 
+    /**
+     * @brief Returns the flags passed to init().
+     */
+    int init_flags();
+
     class Module;
     std::vector<Module *> list_modules();
 }
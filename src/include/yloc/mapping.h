@@ -0,0 +1,44 @@
+#pragma once
+
+#include <yloc/graph.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace yloc
+{
+    /**
+     * @brief Returns the number of hops between every pair of the given vertices (row-major).
+     *
+     * Vertices in different connected components, e.g. MPI processes on different nodes, get
+     * twice the largest distance within a component plus two, so leaving a node is always more
+     * expensive than any distance within a node. Vertices located in a template instance (see
+     * locate_in_instance()) count the hops through the template, e.g. between the cores of two
+     * remote MPI processes, without expanding the instance.
+     */
+    std::vector<uint64_t> hop_distances(const Graph &g, const std::vector<vertex_descriptor_t> &vertices);
+
+    /**
+     * @brief Returns the cost sum(comm[i][j] * dist[perm[i]][perm[j]]) of a mapping.
+     *
+     * @param comm Communication matrix between processes (row-major, n x n)
+     * @param dist Distance matrix between slots (row-major, n x n)
+     * @param perm Slot of every process
+     */
+    uint64_t mapping_cost(const std::vector<uint64_t> &comm, const std::vector<uint64_t> &dist, const std::vector<int> &perm);
+
+    /**
+     * @brief Maps n processes to n slots so that heavily communicating processes are close.
+     *
+     * A greedy phase places the process with the most communication on the most central slot
+     * and then repeatedly the process with the most communication to the placed ones on the
+     * free slot with the lowest weighted distance to them (TreeMatch-style). A refinement phase
+     * swaps pairs of processes as long as this reduces mapping_cost().
+     *
+     * @param comm Communication matrix between processes (row-major, n x n), e.g. bytes sent from i to j
+     * @param dist Distance matrix between slots (row-major, n x n), e.g. from hop_distances()
+     * @param max_passes Maximum number of refinement passes over all pairs
+     * @return The slot of every process
+     */
+    std::vector<int> map_processes(const std::vector<uint64_t> &comm, const std::vector<uint64_t> &dist, int max_passes = 8);
+}
@@ -42,9 +42,12 @@ namespace yloc
                 {make_property_pair("bandwidth", &Adapter::bandwidth)},
                 {make_property_pair("bandwidth_min", &Adapter::bandwidth_min)},
                 {make_property_pair("bandwidth_max", &Adapter::bandwidth_max)},
+                {make_property_pair("link_speed", &Adapter::link_speed)},
                 {make_property_pair("throughput", &Adapter::throughput)},
                 {make_property_pair("latency", &Adapter::latency)},
+                {make_property_pair("memory_tier", &Adapter::memory_tier)},
                 {make_property_pair("frequency", &Adapter::frequency)},
+                {make_property_pair("efficiency_class", &Adapter::efficiency_class)},
                 /** TODO: maybe support multiple return types in Vertex::get("property") (e.g. Vertex::get<return_type>("property"))
                  * or change temperature scale to degree Kelvin and return type to uint64_t */
                 // {make_property_pair("temperature", &Adapter::temperature)},
@@ -79,6 +82,13 @@ namespace yloc
          */
         virtual std::string to_string() const { return {}; }
 
+        /**
+         * @brief Gets description of component if the adapter keeps it (e.g. in a mapped snapshot).
+         *
+         * @return Description, empty if the vertex keeps it in Vertex::m_description.
+         */
+        virtual std::string_view description() const { return {}; }
+
         /** abstract machine model begin */
 
         /** TODO: normalize to millidegrees Kelvin and change to return type uint64_t? */
@@ -143,6 +153,14 @@ namespace yloc
         ADAPTER_PROPERTY(uint64_t, bandwidth_max)
         ADAPTER_PROPERTY(uint64_t, throughput)
 
+        /**
+         * @brief Gets speed of the links of a network component, as configured by the system.
+         *
+         * @return Link speed in the units of the configuration (e.g. a Slurm topology.conf), which are
+         * not necessarily bytes per second, or std::nullopt if the speed is not configured.
+         */
+        ADAPTER_PROPERTY(uint64_t, link_speed)
+
         /**
          * @brief Gets latency of component.
          *
@@ -150,6 +168,13 @@ namespace yloc
          */
         ADAPTER_PROPERTY(uint64_t, latency)
 
+        /**
+         * @brief Gets memory tier of component.
+         *
+         * @return Tier of the memory within its machine, 0 for the fastest tier, or std::nullopt if component is no memory.
+         */
+        ADAPTER_PROPERTY(uint64_t, memory_tier)
+
         /**
          * @brief Gets frequency of component.
          *
@@ -157,6 +182,14 @@ namespace yloc
          */
         ADAPTER_PROPERTY(uint64_t, frequency) // in Hz
 
+        /**
+         * @brief Gets efficiency class of a cpu component on heterogeneous (e.g. P-core/E-core) processors.
+         *
+         * @return Efficiency class, 0 for the most energy-efficient kind and higher values for
+         * more performant kinds, or std::nullopt if the kind of the component is unknown.
+         */
+        ADAPTER_PROPERTY(uint64_t, efficiency_class)
+
         // ADAPTER_PROPERTY(uint64_t, frequency_min) // in Hz
         // ADAPTER_PROPERTY(uint64_t, frequency_max) // in Hz
 
@@ -2,6 +2,8 @@
 
 #include <yloc/status.h> // yloc_status_t
 
+#include <chrono>
+
 namespace yloc
 {
     class Graph;
@@ -9,7 +11,7 @@ namespace yloc
     class Module
     {
     public:
-        enum class init_order : int { FIRST=0, SECOND=1 };
+        enum class init_order : int { FIRST=0, SECOND=1, THIRD=2 };
 
         /** TODO: use pure virtual destructor ? then we must override in sub-classes */
         virtual ~Module() = default; // 0;
@@ -24,16 +26,37 @@ namespace yloc
 
         virtual yloc_status_t export_graph(const Graph &graph, void **output) = 0;
 
+        /**
+         * @brief Updates the module's part of the graph, e.g. samples its dynamic properties.
+         *
+         * With YLOC_ONGOING, it is called by the sampler threads every m_update_interval,
+         * concurrently to readers of the graph, so it must not modify the graph structure
+         * unless m_structural is set.
+         *
+         * @param graph The root graph
+         * @return yloc_status_t
+         */
         virtual yloc_status_t update_graph(Graph &graph) = 0;
-        // Manual(?) trigger for an update on the graph
-        // Thread logic in module or in init?
-        // Probably both, modules that require push logic need internal threads.
-        // Otherwise keep thread logic in init or modules
-        //
-        // An alternative would be to add a auto-update function to the interface,
-        // this would be a good place to add an per-module interval
 
         init_order m_init_order{init_order::FIRST};
         bool m_enabled{true};
+
+        /**
+         * Interval of update_graph() calls with YLOC_ONGOING, zero if the module is not updated
+         * in the background.
+         */
+        std::chrono::milliseconds m_update_interval{0};
+
+        /**
+         * Module only provides static information, so its subgraph can be shared between the
+         * processes of a node (see YLOC_SHARED).
+         */
+        bool m_shareable{false};
+
+        /**
+         * update_graph() changes the graph structure (e.g. reloads the topology), so it holds
+         * structure_mutex() exclusively, which pauses the updates of the sampler meanwhile.
+         */
+        bool m_structural{false};
     };
 }
@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * Header-only MPI helpers for topology-aware rank reordering.
+ * Not included by yloc.h, since yloc itself does not depend on MPI.
+ */
+
+#include <mpi.h>
+
+#include <yloc/graph.h>
+#include <yloc/mapping.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+namespace yloc
+{
+    /**
+     * @brief Returns the graph vertex of every rank of comm (requires the MPI module).
+     */
+    inline std::vector<vertex_descriptor_t> rank_vertices(Graph &g, MPI_Comm comm)
+    {
+        int size;
+        MPI_Comm_size(comm, &size);
+        MPI_Group group, world_group;
+        MPI_Comm_group(comm, &group);
+        MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+        std::vector<int> ranks(size), world_ranks(size);
+        for (int i = 0; i < size; ++i) {
+            ranks[i] = i;
+        }
+        MPI_Group_translate_ranks(group, size, ranks.data(), world_group, world_ranks.data());
+        MPI_Group_free(&group);
+        MPI_Group_free(&world_group);
+
+        std::vector<vertex_descriptor_t> vertices{};
+        for (int world_rank : world_ranks) {
+            auto vd = g.process_map().vertex(g, world_rank);
+            if (!vd.has_value()) {
+                return {};
+            }
+            vertices.push_back(vd.value());
+        }
+        return vertices;
+    }
+
+    /**
+     * @brief Computes a topology-aware placement of the processes of an application on comm.
+     *
+     * The mapping is computed on rank 0 and broadcast, so only rank 0 needs the matrix.
+     *
+     * @param comm_matrix Communication matrix of the application processes (row-major, size x size)
+     * @return The rank in comm whose location application process i should use, for every i
+     */
+    inline std::vector<int> compute_rank_mapping(Graph &g, MPI_Comm comm, const std::vector<uint64_t> &comm_matrix)
+    {
+        int size, rank;
+        MPI_Comm_size(comm, &size);
+        MPI_Comm_rank(comm, &rank);
+
+        std::vector<int> perm(size);
+        if (rank == 0) {
+            auto vertices = rank_vertices(g, comm);
+            std::vector<int> mapping{};
+            if (!vertices.empty()) {
+                mapping = map_processes(comm_matrix, hop_distances(g, vertices));
+            }
+            for (int i = 0; i < size; ++i) {
+                perm[i] = mapping.empty() ? i : mapping[i];
+            }
+        }
+        MPI_Bcast(perm.data(), size, MPI_INT, 0, comm);
+        return perm;
+    }
+
+    /**
+     * @brief Creates a communicator in which rank i is the process placed for application process i.
+     *
+     * Use the ranks of newcomm as application process ids (rows of comm_matrix).
+     *
+     * @return MPI_SUCCESS or the error code of MPI_Comm_split
+     */
+    inline int reorder_comm(Graph &g, MPI_Comm comm, const std::vector<uint64_t> &comm_matrix, MPI_Comm *newcomm)
+    {
+        auto perm = compute_rank_mapping(g, comm, comm_matrix);
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+        int key = 0;
+        for (int i = 0; i < static_cast<int>(perm.size()); ++i) {
+            if (perm[i] == rank) {
+                key = i;
+            }
+        }
+        return MPI_Comm_split(comm, 0, key, newcomm);
+    }
+
+    /** @brief Arguments of MPI_Dist_graph_create_adjacent for one process. */
+    struct dist_graph_adjacency {
+        std::vector<int> sources{};
+        std::vector<int> source_weights{};
+        std::vector<int> destinations{};
+        std::vector<int> destination_weights{};
+    };
+
+    /**
+     * @brief Returns the neighbors of application process i in a communication matrix.
+     *
+     * Weights larger than INT_MAX are clamped. Together with reorder_comm():
+     * @code
+     * auto adj = yloc::dist_graph_adjacency_of(matrix, rank_in_newcomm);
+     * MPI_Dist_graph_create_adjacent(newcomm, adj.sources.size(), adj.sources.data(), adj.source_weights.data(),
+     *                                adj.destinations.size(), adj.destinations.data(), adj.destination_weights.data(),
+     *                                MPI_INFO_NULL, 0, &graph_comm);
+     * @endcode
+     */
+    inline dist_graph_adjacency dist_graph_adjacency_of(const std::vector<uint64_t> &comm_matrix, int i)
+    {
+        size_t n = 0;
+        while (n * n < comm_matrix.size()) {
+            n++;
+        }
+        auto weight = [](uint64_t w) { return static_cast<int>(std::min<uint64_t>(w, INT_MAX)); };
+
+        dist_graph_adjacency adj{};
+        for (size_t j = 0; j < n; ++j) {
+            if (comm_matrix[j * n + i] != 0) {
+                adj.sources.push_back(static_cast<int>(j));
+                adj.source_weights.push_back(weight(comm_matrix[j * n + i]));
+            }
+            if (comm_matrix[i * n + j] != 0) {
+                adj.destinations.push_back(static_cast<int>(j));
+                adj.destination_weights.push_back(weight(comm_matrix[i * n + j]));
+            }
+        }
+        return adj;
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <yloc/graph.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace yloc
+{
+    /**
+     * @brief Merkle-style hash of the subtree below root.
+     *
+     * Combines the component type and the static properties of every vertex with the sorted
+     * hashes of its children (CHILD edges), so equal hardware gives equal hashes independent of
+     * the order of discovery. Logical components such as MPI processes are ignored. Distance
+     * tables and descriptions are not included, snapshot_hash() compares machines completely.
+     */
+    uint64_t subtree_hash(const Graph &g, vertex_descriptor_t root);
+
+    /**
+     * @brief Hash of the bytes of a snapshot, equal snapshots describe equal machines including tables and attributes.
+     */
+    uint64_t snapshot_hash(const std::vector<char> &snapshot);
+
+    /**
+     * @brief Immutable subgraph of a kind of machine (SKU), shared by all machines of that kind.
+     */
+    struct NodeTemplate {
+        uint64_t hash{};
+        Graph graph{};               // root is graph.get_root_vertex(), vertex i is vertex i of the snapshot
+        std::vector<char> snapshot{}; // backs the property values of the vertices in graph
+    };
+
+    /**
+     * @brief Creates a node template from a machine snapshot (see make_snapshot()).
+     *
+     * @return The template or nullptr if snapshot is invalid
+     */
+    std::shared_ptr<const NodeTemplate> make_node_template(std::vector<char> snapshot);
+
+    /**
+     * @brief A machine that references a node template plus a small per-instance overlay.
+     *
+     * Vertices of the instance are addressed by their descriptor in the template graph. The
+     * overlay holds identifiers of the single instance (e.g. "mpi_rank:<rank>" at the vertex of
+     * the process) and an adapter slot per vertex (e.g. dynamic data of a remote GPU), which takes
+     * precedence over the template. Vertices of the graph below the machine vertex can be attached
+     * to a vertex of the instance, so that hop_distances() counts the hops through the template.
+     */
+    class TemplateInstance
+    {
+    public:
+        explicit TemplateInstance(std::shared_ptr<const NodeTemplate> node_template) : m_template{std::move(node_template)} {}
+
+        const NodeTemplate &node_template() const { return *m_template; }
+
+        const Graph &graph() const { return m_template->graph; }
+
+        void set_identifier(const std::string &id, vertex_descriptor_t vd) { m_identifiers[id] = vd; }
+
+        /**
+         * @brief Returns the template vertex with identifier id, instance identifiers first.
+         */
+        std::optional<vertex_descriptor_t> find(const std::string &id) const
+        {
+            auto iter = m_identifiers.find(id);
+            if (iter != m_identifiers.end()) {
+                return iter->second;
+            }
+            auto template_iter = graph().identifier_map().find(id);
+            if (template_iter != graph().identifier_map().end()) {
+                return template_iter->second;
+            }
+            return {};
+        }
+
+        /**
+         * @brief Sets the instance-specific adapter of template vertex vd (not owned, nullptr clears it).
+         */
+        void set_adapter(vertex_descriptor_t vd, Adapter *adapter)
+        {
+            if (m_adapters.empty()) {
+                m_adapters.resize(boost::num_vertices(graph()), nullptr);
+            }
+            m_adapters[vd] = adapter;
+        }
+
+        Adapter *adapter(vertex_descriptor_t vd) const { return vd < m_adapters.size() ? m_adapters[vd] : nullptr; }
+
+        /**
+         * @brief Returns template vertex vd as seen by this instance, with the instance adapter first.
+         */
+        Vertex vertex(vertex_descriptor_t vd) const
+        {
+            Vertex v = graph()[vd];
+            if (Adapter *a = adapter(vd)) {
+                v.m_adapters.insert(v.m_adapters.begin(), a);
+            }
+            return v;
+        }
+
+        /**
+         * @brief Returns property name of template vertex vd, the instance adapter first.
+         */
+        template <class RT>
+        std::optional<RT> get(vertex_descriptor_t vd, std::string_view name) const
+        {
+            return vertex(vd).get<RT>(name);
+        }
+
+        /**
+         * @brief Locates vertex graph_vd of the graph (e.g. a remote MPI process) at template vertex vd.
+         */
+        void attach(vertex_descriptor_t graph_vd, vertex_descriptor_t vd) { m_attached[graph_vd] = vd; }
+
+        /**
+         * @return The template vertex that graph vertex graph_vd is attached to, if any.
+         */
+        std::optional<vertex_descriptor_t> location(vertex_descriptor_t graph_vd) const
+        {
+            auto iter = m_attached.find(graph_vd);
+            if (iter != m_attached.end()) {
+                return iter->second;
+            }
+            return {};
+        }
+
+    private:
+        std::shared_ptr<const NodeTemplate> m_template;
+        std::unordered_map<std::string, vertex_descriptor_t> m_identifiers{};
+        std::vector<Adapter *> m_adapters{};                                // by template vertex, empty until an adapter is set
+        std::unordered_map<vertex_descriptor_t, vertex_descriptor_t> m_attached{}; // template vertex by graph vertex
+    };
+
+    /**
+     * @brief Lets vertex vd of graph g (e.g. a remote machine) reference a node template.
+     *
+     * Vertex vd gets the type of the template root if it has none yet, and serves the properties
+     * of the template root (e.g. its memory) through Vertex::get.
+     *
+     * @return The new instance
+     */
+    TemplateInstance *add_template_instance(Graph &g, vertex_descriptor_t vd, std::shared_ptr<const NodeTemplate> node_template);
+
+    /**
+     * @brief A vertex of a template instance.
+     */
+    struct instance_vertex {
+        vertex_descriptor_t machine; // vertex of the instance in the graph
+        vertex_descriptor_t vd;      // vertex in the template graph
+    };
+
+    /**
+     * @brief Returns the template vertex at which vertex vd of graph g is located.
+     *
+     * That is the template root for a vertex with a template instance, and the vertex a child
+     * of such a vertex is attached to (see TemplateInstance::attach()).
+     */
+    std::optional<instance_vertex> locate_in_instance(const Graph &g, vertex_descriptor_t vd);
+
+    /**
+     * @brief Adds a copy of the template subgraph of vertex vd below vd.
+     *
+     * Needed for algorithms that traverse the devices of remote machines in the graph itself,
+     * hop_distances() resolves attached vertices through the instance without the copy.
+     * Identifiers and tables of the copy are prefixed with prefix (e.g. "<hostname>/"). The
+     * instance stays registered, since the copy reads its property values from the template.
+     */
+    yloc_status_t expand_template_instance(Graph &g, vertex_descriptor_t vd, const std::string &prefix);
+}
@@ -55,6 +55,46 @@ namespace yloc
                                          }});
     }
 
+    /**
+     * @brief Orders the vertices of a distance table by their distance from vertex v.
+     *
+     * If v is not part of the table itself, the table vertex whose cpu affinity mask most tightly
+     * contains the affinity mask of v (or of its closest ancestor with a mask) is used as origin.
+     * E.g. `ordered_by_distance(g, core_vd, "numa_latency")` returns the NUMA nodes ordered by latency from a core.
+     *
+     * @param g The graph
+     * @param v The origin vertex
+     * @param table_name Name of the distance table, e.g. "numa_latency" or "numa_bandwidth"
+     * @return Table vertices from closest to farthest, empty if the table or a matching origin is not available.
+     */
+    std::vector<vertex_descriptor_t> ordered_by_distance(const Graph &g, vertex_descriptor_t v, const std::string &table_name);
+
+    /**
+     * @brief Returns the best target memory (NUMA node) for accesses from an initiator.
+     *
+     * Uses the "memory_bandwidth" or "memory_latency" tables (hwloc memory attributes),
+     * for latency falling back to the relative "numa_latency" table if no attributes are available.
+     *
+     * @param g The graph
+     * @param initiator The accessing vertex, e.g. a core or a package
+     * @param metric DistanceTable::kind::BANDWIDTH for the highest bandwidth, DistanceTable::kind::LATENCY for the lowest latency
+     * @return The memory vertex or std::nullopt if there is no information for the initiator.
+     */
+    std::optional<vertex_descriptor_t> best_memory_target(const Graph &g, vertex_descriptor_t initiator, DistanceTable::kind metric);
+
+    /**
+     * @brief Returns the n most performant logical cores close to a vertex, e.g. a GPU.
+     *
+     * Logical cores are ordered by decreasing efficiency class (performance cores first),
+     * then by increasing number of hops from vertex v. Without cpu kind information all
+     * logical cores are treated as one class.
+     *
+     * @param g The graph
+     * @param v The vertex to search near to
+     * @param n The maximum number of logical cores to return
+     */
+    std::vector<vertex_descriptor_t> most_performant_pus(const Graph &g, vertex_descriptor_t v, size_t n);
+
 #if YLOC_NOT_IMPLEMENTED_YET
     class Query
     {
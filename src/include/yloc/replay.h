@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <yloc/status.h>
+#include <yloc/time_series.h>
+
+namespace yloc
+{
+    /**
+     * @brief Plays back recorded samples of dynamic properties (see the replay module).
+     *
+     * Recordings are files of SeriesFileWriter (e.g. written with YLOC_SAMPLE_FILE) or CSV files
+     * with lines "time,vertex,property,value", time in nanoseconds. Properties that are not in
+     * dynamic_properties() are skipped, as is a header line.
+     *
+     * The playback position starts at the first sample. With a speed > 0, it follows the steady
+     * clock scaled by speed (1 is real time, 100 is a hundred times faster), with speed 0 it is
+     * only advanced by step(), to the time of the next sample (as fast as possible).
+     */
+    class Replay
+    {
+    public:
+        struct series {
+            std::string vertex;
+            size_t property; // index in dynamic_properties()
+            std::vector<sample> samples; // oldest first
+        };
+
+        yloc_status_t open(const std::string &path);
+
+        const std::vector<series> &recorded() const { return m_series; }
+
+        /**
+         * @brief Starts the playback at the first sample.
+         */
+        void start(double speed);
+
+        double speed() const { return m_speed; }
+
+        /**
+         * @return The playback position, in the time of the recording.
+         */
+        int64_t position() const;
+
+        /**
+         * @brief Advances the position to the time of the next sample, with speed 0.
+         *
+         * @return false if the position is at the last sample
+         */
+        bool step();
+
+        bool finished() const { return m_times.empty() || position() >= m_times.back(); }
+
+        /**
+         * @return Value of series at the playback position, none before its first sample.
+         */
+        std::optional<uint64_t> value(size_t series) const;
+
+    private:
+        yloc_status_t read_csv(const std::string &path);
+        yloc_status_t read_series_file(const std::string &path);
+
+        std::vector<series> m_series{};
+        std::vector<int64_t> m_times{}; // distinct sample times, ascending
+        double m_speed{1};
+        std::chrono::steady_clock::time_point m_start{};
+        std::atomic<size_t> m_cursor{0}; // index in m_times with speed 0
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <yloc/graph.h>
+
+namespace yloc
+{
+    enum class rollup_op : int { SUM = 0, MEAN, MAX };
+
+    /**
+     * @brief Aggregate of a sampled property over the descendants of a component type, for every vertex.
+     *
+     * The value of a vertex combines the latest samples of all vertices of the type in its
+     * subtree (CHILD hierarchy), including the vertex itself. The sampler updates the values of
+     * the ancestors whenever a sample changes, so reading the aggregate of any level is O(1).
+     */
+    class Rollup
+    {
+    public:
+        Rollup(const Graph &g, std::string name, size_t property, rollup_op op, std::function<bool(const Component *)> is_member);
+
+        const std::string &name() const { return m_name; }
+
+        /**
+         * @return The aggregate of vertex vd or std::nullopt if no member below vd has a sample yet.
+         */
+        std::optional<double> value(vertex_descriptor_t vd) const
+        {
+            if (vd >= m_values.size() || m_values[vd].count.load(std::memory_order_acquire) == 0) {
+                return {};
+            }
+            return m_values[vd].value.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Applies the new sample of member vd to the aggregates of vd and its ancestors.
+         *
+         * Called by the sampler, updates must be serialized and hold structure_mutex() shared.
+         */
+        void update(vertex_descriptor_t vd, uint64_t value);
+
+        bool is_member(vertex_descriptor_t vd) const { return vd < m_values.size() && m_values[vd].member; }
+
+        const Graph &graph() const { return m_graph; }
+
+        size_t property() const { return m_property; }
+
+    private:
+        /* writer state of a vertex, value and count are published for lock-free readers */
+        struct state {
+            uint64_t sum{0};
+            uint64_t max{0};
+            std::optional<uint64_t> own{}; // latest sample if the vertex is a member
+            bool member{false};
+            std::atomic<double> value{0};
+            std::atomic<uint64_t> count{0}; // members with a sample in the subtree
+        };
+
+        void publish(state &s);
+
+        /* raises max to the maxima of the children of vd */
+        void children_max(vertex_descriptor_t vd, uint64_t &max) const;
+
+        const Graph &m_graph;
+        std::string m_name;
+        size_t m_property;
+        rollup_op m_op;
+        std::vector<state> m_values;
+    };
+
+    /**
+     * @brief Declares rollup name over the members (vertices for which is_member(type) is true) of sampled property.
+     *
+     * The graph structure must be complete, since the rollup is computed for the vertices that
+     * exist now. Current samples are included. Values are maintained while sampling (YLOC_ONGOING).
+     * Later changes of the structure (e.g. ModuleHwloc::update_graph()) are not reflected: vertices
+     * added later have no value, and members that move keep counting for their former ancestors.
+     *
+     * @return The rollup or nullptr if property is not sampled (see dynamic_properties())
+     */
+    const Rollup *add_rollup(const Graph &g, std::string name, std::string_view property, rollup_op op, std::function<bool(const Component *)> is_member);
+
+    /**
+     * @brief Declares rollup name of property over the descendants of component type ComponentType.
+     *
+     * E.g. the total GPU power of every machine, package and PCI bridge:
+     *   auto *gpu_power = add_rollup<GPU>(g, "gpu_power", "power", rollup_op::SUM);
+     *   gpu_power->value(g.get_root_vertex());
+     */
+    template <class ComponentType>
+    const Rollup *add_rollup(const Graph &g, std::string name, std::string_view property, rollup_op op)
+    {
+        return add_rollup(g, std::move(name), property, op, [](const Component *type) { return type->is_a<ComponentType>(); });
+    }
+
+    /**
+     * @return The rollup name of graph g or nullptr if there is no such rollup.
+     */
+    const Rollup *find_rollup(const Graph &g, std::string_view name);
+
+    /**
+     * @brief Applies a changed sample of property of vertex vd to all rollups of graph g (called by the sampler).
+     */
+    void update_rollups(const Graph &g, vertex_descriptor_t vd, size_t property, uint64_t value);
+}
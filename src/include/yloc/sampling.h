@@ -0,0 +1,320 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <yloc/graph.h>
+#include <yloc/modules/adapter.h>
+#include <yloc/time_series.h>
+
+namespace yloc
+{
+    class Module;
+
+    /**
+     * @brief Names of the dynamic properties, which are sampled in the background with YLOC_ONGOING.
+     */
+    const std::vector<std::string_view> &dynamic_properties();
+
+    /**
+     * @brief Returns the index of dynamic property name in dynamic_properties().
+     */
+    std::optional<size_t> dynamic_property_index(std::string_view name);
+
+    /**
+     * @brief Lock of the graph structure (vertices and hierarchy) against the sampler.
+     *
+     * The sampler holds it shared while it updates a module, since samples walk the hierarchy
+     * (e.g. for rollups). Changes of the structure while sampling must hold it exclusively
+     * (see Module::m_structural).
+     */
+    std::shared_mutex &structure_mutex();
+
+    /**
+     * @brief Latest sample and history of a property, published to readers without locks.
+     *
+     * Writers are serialized by the sequence number, readers of the latest sample retry while a
+     * write is in progress (seqlock). The history is allocated with the first sample.
+     */
+    class SampleSlot
+    {
+    public:
+        SampleSlot() = default;
+        SampleSlot(const SampleSlot &) = delete;
+        SampleSlot &operator=(const SampleSlot &) = delete;
+
+        ~SampleSlot() { delete m_series.load(std::memory_order_relaxed); }
+
+        void write(uint64_t value, int64_t time)
+        {
+            uint32_t sequence = lock();
+            m_value.store(value, std::memory_order_relaxed);
+            m_time.store(time, std::memory_order_relaxed);
+
+            TimeSeries *series = m_series.load(std::memory_order_relaxed);
+            if (series == nullptr) {
+                series = new TimeSeries{};
+                m_series.store(series, std::memory_order_release);
+            }
+            series->append({value, time});
+            m_sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Appends the latest value to the history at time without a new reading.
+         *
+         * Keeps the history evenly spaced while a property backs off, so that its aggregates
+         * weight values by time. The latest sample keeps the time it was read.
+         */
+        void carry(int64_t time)
+        {
+            uint32_t sequence = lock();
+            TimeSeries *series = m_series.load(std::memory_order_relaxed);
+            if (series != nullptr && time > m_time.load(std::memory_order_relaxed)) {
+                series->append({m_value.load(std::memory_order_relaxed), time});
+            }
+            m_sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * @return The latest sample or std::nullopt if the property was not sampled yet.
+         */
+        std::optional<sample> read() const
+        {
+            uint32_t before, after;
+            sample s;
+            do {
+                before = m_sequence.load(std::memory_order_acquire);
+                s.value = m_value.load(std::memory_order_relaxed);
+                s.time = m_time.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = m_sequence.load(std::memory_order_relaxed);
+            } while ((before & 1) || before != after);
+            return s.time != 0 ? std::optional<sample>{s} : std::nullopt;
+        }
+
+        /**
+         * @return The history or nullptr if the property was not sampled yet.
+         */
+        const TimeSeries *series() const { return m_series.load(std::memory_order_acquire); }
+
+    private:
+        /* serializes writers, which release the slot by storing the returned sequence number + 2 */
+        uint32_t lock()
+        {
+            uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+            while ((sequence & 1) || !m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                sequence = m_sequence.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            return sequence;
+        }
+
+        std::atomic<TimeSeries *> m_series{nullptr};
+        std::atomic<uint32_t> m_sequence{0};
+        std::atomic<uint64_t> m_value{0};
+        std::atomic<int64_t> m_time{0};
+    };
+
+    /**
+     * @brief Adapter that serves the latest samples of the dynamic properties of a vertex.
+     *
+     * It precedes the adapters of the modules, so reads of sampled properties do not call into
+     * the (possibly blocking) module adapters. Properties without sample fall through to them.
+     */
+    class SampledAdapter : public Adapter
+    {
+    public:
+        SampledAdapter(const Graph &g, vertex_descriptor_t vd) : m_graph{g}, m_vd{vd}, m_slots(dynamic_properties().size()), m_rates(dynamic_properties().size()) {}
+
+        /**
+         * @brief Reads the dynamic properties of source that are due and publishes the values.
+         *
+         * With a base interval (the update interval of the calling module), every property is
+         * read at its own, adaptive interval: a multiple of base_interval that grows for values
+         * that do not change and with the sampling load (see sampling_budget()). Without, all
+         * properties are read.
+         *
+         * @param time Time of the samples in nanoseconds of std::chrono::steady_clock, e.g. the
+         *             recorded time of replayed values, now if not given
+         * @return Number of values read from source
+         */
+        size_t sample_from(const Adapter *source, std::chrono::nanoseconds base_interval = std::chrono::nanoseconds{0},
+                           std::optional<int64_t> time = std::nullopt);
+
+        /**
+         * @return Current sampling interval of property, zero if it was not sampled with a base interval.
+         */
+        std::chrono::nanoseconds interval(size_t property) const { return std::chrono::nanoseconds{m_rates[property].interval.load(std::memory_order_relaxed)}; }
+
+        /**
+         * @return Average cpu time of reading property from its source.
+         */
+        std::chrono::nanoseconds cost(size_t property) const { return std::chrono::nanoseconds{m_rates[property].cost.load(std::memory_order_relaxed)}; }
+
+        /**
+         * @return Estimated fraction of a core that sampling the properties costs without load-dependent stretching.
+         */
+        double desired_load() const;
+
+        std::optional<sample> latest(size_t property) const { return m_slots[property].read(); }
+
+        std::optional<sample> latest(std::string_view name) const
+        {
+            auto index = dynamic_property_index(name);
+            return index.has_value() ? latest(*index) : std::nullopt;
+        }
+
+        const TimeSeries *series(size_t property) const { return m_slots[property].series(); }
+
+        const TimeSeries *series(std::string_view name) const
+        {
+            auto index = dynamic_property_index(name);
+            return index.has_value() ? series(*index) : nullptr;
+        }
+
+        std::optional<uint64_t> memory_usage() const override { return value("memory_usage"); }
+        std::optional<uint64_t> memory_load() const override { return value("memory_load"); }
+        std::optional<uint64_t> throughput() const override { return value("throughput"); }
+        std::optional<uint64_t> power() const override { return value("power"); }
+        std::optional<uint64_t> usage() const override { return value("usage"); }
+        std::optional<uint64_t> load() const override { return value("load"); }
+        std::optional<uint64_t> pci_throughput() const override { return value("pci_throughput"); }
+        std::optional<uint64_t> pci_throughput_read() const override { return value("pci_throughput_read"); }
+        std::optional<uint64_t> pci_throughput_write() const override { return value("pci_throughput_write"); }
+
+    private:
+        std::optional<uint64_t> value(std::string_view name) const
+        {
+            auto s = latest(name);
+            return s.has_value() ? std::optional<uint64_t>{s->value} : std::nullopt;
+        }
+
+        /* adaptive sampling rate of a property, atomics are read by the controller and for inspection */
+        struct rate {
+            std::atomic<int64_t> interval{0}; // nanoseconds
+            std::atomic<int64_t> desired{0};  // interval without load-dependent stretching
+            std::atomic<int64_t> cost{0};     // nanoseconds of cpu time per read
+            int64_t next_due{0};
+            uint32_t unchanged{0};
+            uint32_t backoff{1};
+        };
+
+        const Graph &m_graph;
+        vertex_descriptor_t m_vd; // for the rollups of the vertex
+        std::vector<SampleSlot> m_slots;
+        std::vector<rate> m_rates;
+        std::mutex m_sample_mutex{}; // serializes modules that sample the same vertex
+    };
+
+    /**
+     * @brief Returns the sampled adapter of vertex vd, it is created on first use.
+     *
+     * Must be called before the sampler is started (i.e. in Module::init_graph()), since it
+     * modifies the adapters of the vertex.
+     */
+    SampledAdapter *sampled_adapter(Graph &g, vertex_descriptor_t vd);
+
+    /**
+     * @return The sampled adapter of vertex v or nullptr if v is not sampled.
+     */
+    const SampledAdapter *find_sampled_adapter(const Vertex &v);
+
+    /**
+     * @brief Statistics of the samples of property of vertex v in the last window, without adapter calls.
+     *
+     * E.g. the mean GPU power over the last 30 seconds:
+     *   window_statistics(g[vd], "power", std::chrono::seconds{30})->mean
+     *
+     * @return The statistics or std::nullopt if the property has no samples in the window
+     */
+    std::optional<aggregate> window_statistics(const Vertex &v, std::string_view property, std::chrono::nanoseconds window, resolution r = resolution::RAW);
+
+    /**
+     * @brief Returns the cpu time budget of sampling as a fraction of one core.
+     *
+     * Set by YLOC_SAMPLING_BUDGET in percent of a core, 0.5 by default. If the estimated cost of
+     * all adaptive sampling exceeds the budget, all intervals are stretched by the same factor.
+     */
+    double sampling_budget();
+
+    /**
+     * @return The factor (>= 1) by which adaptive sampling intervals are currently stretched.
+     */
+    double sampling_stretch();
+
+    /**
+     * @brief Recomputes sampling_stretch() from the costs and intervals of all sampled properties.
+     *
+     * Called periodically by the sampler.
+     */
+    void update_sampling_stretch();
+
+    struct sampling_rate {
+        vertex_descriptor_t vd;
+        std::string_view property;
+        std::chrono::nanoseconds interval;
+        std::chrono::nanoseconds cost;
+    };
+
+    /**
+     * @brief Returns the current interval and cost of all adaptively sampled properties of graph g.
+     */
+    std::vector<sampling_rate> sampling_rates(const Graph &g);
+
+    /**
+     * @brief Scheduler that drives Module::update_graph() of every module with an update interval.
+     *
+     * A small pool of threads takes the module that is due next, so slow modules do not delay the
+     * others and a module is never updated concurrently with itself. Updates of modules with
+     * m_structural set exclude all other updates (see structure_mutex()).
+     */
+    class Sampler
+    {
+    public:
+        Sampler(Graph &g, std::vector<Module *> modules) : m_graph{g}, m_modules{std::move(modules)} {}
+
+        ~Sampler() { stop(); }
+
+        /**
+         * @brief Starts num_threads threads (0: one per sampled module, at most 4).
+         */
+        void start(size_t num_threads = 0);
+
+        /**
+         * @brief Stops the threads after their current update and joins them.
+         */
+        void stop();
+
+        bool running() const { return !m_threads.empty(); }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct entry {
+            clock::time_point due;
+            Module *module; // nullptr for the sampling load controller
+        };
+
+        static bool later(const entry &a, const entry &b) { return a.due > b.due; }
+
+        void run();
+
+        Graph &m_graph;
+        std::vector<Module *> m_modules;
+        std::vector<entry> m_queue{}; // min-heap by due time, modules that are not being updated
+        std::vector<std::thread> m_threads{};
+        std::mutex m_mutex{};
+        std::condition_variable m_cv{};
+        bool m_stop{false};
+    };
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <yloc/graph.h>
+#include <yloc/status.h>
+#include <yloc/time_series.h>
+
+namespace yloc
+{
+    /**
+     * @brief Writer of an append-only, block-compressed time-series file.
+     *
+     * The samples of each series (a property of a vertex) are buffered and written in blocks of
+     * up to block_capacity samples. A block stores its time range and two columns, timestamps
+     * encoded by delta-of-delta and values XORed with their predecessor (as in Facebook's
+     * Gorilla), so regular sampling intervals and unchanged values take about one bit each.
+     * close() appends an index of all blocks and the series names. Files use the native byte order.
+     * Every record is flushed to the file when it is written, so a reader of a file whose writer
+     * was killed finds all complete records.
+     */
+    class SeriesFileWriter
+    {
+    public:
+        static constexpr size_t block_capacity = 1024;
+
+        SeriesFileWriter() = default;
+        ~SeriesFileWriter() { close(); }
+
+        /**
+         * @brief Creates (or truncates) the file at path.
+         */
+        yloc_status_t open(const std::string &path);
+
+        bool is_open() const { return m_file.is_open(); }
+
+        /**
+         * @brief Adds a series, named by its vertex (e.g. an identifier) and property.
+         *
+         * @return The id of the series
+         */
+        uint32_t add_series(const std::string &vertex, std::string_view property);
+
+        /**
+         * @brief Appends a sample to series, times must not decrease.
+         */
+        void append(uint32_t series, int64_t time, uint64_t value);
+
+        /**
+         * @brief Writes all buffered samples as (partial) blocks.
+         */
+        void flush();
+
+        /**
+         * @brief Writes the buffered samples of the series whose oldest buffered sample is older than time.
+         */
+        void flush(int64_t time);
+
+        /**
+         * @brief Flushes and writes the index, the file is complete afterwards.
+         */
+        void close();
+
+    private:
+        struct block_index {
+            uint32_t series;
+            int64_t min_time;
+            int64_t max_time;
+            uint64_t offset;
+        };
+
+        void write_block(uint32_t series);
+
+        std::ofstream m_file{};
+        std::vector<std::string> m_names{};              // by series id
+        std::vector<std::vector<sample>> m_buffers{};     // by series id
+        std::vector<block_index> m_index{};
+    };
+
+    /**
+     * @brief Reader of a file written by SeriesFileWriter.
+     *
+     * The index is read from the end of the file, or rebuilt from the block headers if the file
+     * was not closed (e.g. the writing process was killed). Range scans only read the blocks
+     * whose time range overlaps the range.
+     */
+    class SeriesFileReader
+    {
+    public:
+        struct series_info {
+            uint32_t id;
+            std::string vertex;
+            std::string property;
+        };
+
+        yloc_status_t open(const std::string &path);
+
+        const std::vector<series_info> &series() const { return m_series; }
+
+        std::optional<uint32_t> find(std::string_view vertex, std::string_view property) const;
+
+        /**
+         * @brief Returns the samples of series with from <= time <= to, oldest first.
+         */
+        std::vector<sample> scan(uint32_t series, int64_t from, int64_t to);
+
+        /**
+         * @return Time range of all samples in the file.
+         */
+        std::pair<int64_t, int64_t> time_range() const { return {m_min_time, m_max_time}; }
+
+        /**
+         * @return Number of blocks read by scan() so far.
+         */
+        size_t blocks_read() const { return m_blocks_read; }
+
+    private:
+        struct block_index {
+            int64_t min_time;
+            int64_t max_time;
+            uint64_t offset;
+        };
+
+        bool read_footer(uint64_t file_size);
+        bool scan_records(uint64_t file_size);
+
+        std::ifstream m_file{};
+        std::vector<series_info> m_series{};
+        std::vector<std::vector<block_index>> m_blocks{}; // by series id, ordered by time
+        int64_t m_min_time{0};
+        int64_t m_max_time{0};
+        size_t m_blocks_read{0};
+    };
+
+    /**
+     * @brief Persists the samples of the sampler (see YLOC_SAMPLE_FILE).
+     *
+     * Series are named by the identifier of their vertex (or "vd:<descriptor>") and times are
+     * converted to nanoseconds since the epoch of std::chrono::system_clock.
+     */
+    class SampleRecorder
+    {
+    public:
+        yloc_status_t open(const Graph &g, const std::string &path);
+
+        /**
+         * @brief Appends a sample of property (index in dynamic_properties()) of vertex vd of graph g.
+         */
+        void record(const Graph &g, vertex_descriptor_t vd, size_t property, int64_t time, uint64_t value);
+
+        void close();
+
+        /**
+         * @brief Writes the samples that are buffered for longer than max_block_age (called by the sampler).
+         */
+        void flush_blocks();
+
+        /** upper bound of the time until a sample is in the file, so a recording is usable after a crash */
+        static constexpr std::chrono::seconds max_block_age{1};
+
+    private:
+        std::mutex m_mutex{};
+        const Graph *m_graph{nullptr};
+        SeriesFileWriter m_writer{};
+        std::vector<std::string> m_vertex_names{};
+        std::unordered_map<uint64_t, uint32_t> m_series{}; // by vd and property
+        int64_t m_clock_offset{0};
+    };
+
+    /**
+     * @return The recorder of the sampler or nullptr if samples are not recorded.
+     */
+    SampleRecorder *sample_recorder();
+
+    /**
+     * @brief Starts recording the samples of graph g to a new file at path.
+     */
+    yloc_status_t start_recording(const Graph &g, const std::string &path);
+
+    /**
+     * @brief Stops recording and completes the file.
+     */
+    void stop_recording();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <yloc/graph.h>
+#include <yloc/status.h>
+
+namespace yloc
+{
+    /**
+     * @brief Names of the static machine model properties that are stored in snapshots.
+     */
+    const std::vector<std::string_view> &static_properties();
+
+    /**
+     * @brief Serializes the static information of graph g into a flat, position-independent buffer.
+     *
+     * The snapshot holds component types (by name), descriptions, identifiers, the static
+     * properties of the machine model (e.g. memory, bdfid, cpu_affinity_mask), all edges,
+     * distance tables and cpu kinds. Dynamic properties are not part of the snapshot.
+     */
+    std::vector<char> make_snapshot(const Graph &g);
+
+    /**
+     * @brief Serializes the subgraph induced by vertices, vertices[0] being its root.
+     *
+     * The root is stored without identifier and description (e.g. the hostname), so that
+     * snapshots of machines with identical hardware are byte-identical.
+     */
+    std::vector<char> make_snapshot(const Graph &g, const std::vector<vertex_descriptor_t> &vertices);
+
+    /**
+     * @brief Adds the vertices and edges of a snapshot to graph g.
+     *
+     * Property values are served directly from data, which must outlive the graph. Vertices with
+     * an identifier that already exists in g are merged with the existing vertex.
+     *
+     * @param root Set to the vertex of the snapshot's root if not nullptr
+     * @return YLOC_STATUS_INVALID_ARGS if data is no valid snapshot of this yloc build
+     */
+    yloc_status_t load_snapshot(Graph &g, const char *data, size_t size, vertex_descriptor_t *root = nullptr);
+
+    /**
+     * @brief Adds the vertices and edges of a snapshot below an existing vertex, e.g. a remote machine.
+     *
+     * The snapshot's root is merged into vertex root. Identifiers and distance table names are
+     * prefixed with prefix (e.g. "node042/"), so that they do not collide with the local
+     * machine, and cpu kinds are not imported. Data must outlive the graph.
+     */
+    yloc_status_t load_snapshot_at(Graph &g, vertex_descriptor_t root, const std::string &prefix, const char *data, size_t size);
+}
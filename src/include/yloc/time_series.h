@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace yloc
+{
+    /**
+     * @brief Fixed-capacity ring buffer with a single writer and any number of lock-free readers.
+     *
+     * The writer announces a position before it overwrites the oldest element, so readers can
+     * detect elements that were overwritten while they copied them (like a seqlock per element).
+     */
+    template <class T>
+    class RingBuffer
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "elements are copied word by word");
+
+        static constexpr size_t s_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    public:
+        explicit RingBuffer(size_t capacity) : m_elements(capacity) {}
+
+        size_t capacity() const { return m_elements.size(); }
+
+        /**
+         * @brief Appends value and overwrites the oldest element if the buffer is full (single writer).
+         */
+        void push(const T &value)
+        {
+            uint64_t position = m_announced.load(std::memory_order_relaxed);
+            m_announced.store(position + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            std::array<uint64_t, s_words> words{};
+            std::memcpy(words.data(), &value, sizeof(T));
+            auto &element = m_elements[position % capacity()];
+            for (size_t i = 0; i < s_words; ++i) {
+                element[i].store(words[i], std::memory_order_relaxed);
+            }
+            m_committed.store(position + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Calls f(const T &) for the elements from newest to oldest until it returns false.
+         */
+        template <class F>
+        void visit_newest(F &&f) const
+        {
+            uint64_t committed = m_committed.load(std::memory_order_acquire);
+            uint64_t oldest = committed > capacity() ? committed - capacity() : 0;
+            for (uint64_t position = committed; position-- > oldest;) {
+                std::array<uint64_t, s_words> words;
+                const auto &element = m_elements[position % capacity()];
+                for (size_t i = 0; i < s_words; ++i) {
+                    words[i] = element[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // the element was overwritten while copying it, and so are all older ones
+                if (position + capacity() < m_announced.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                T value;
+                std::memcpy(&value, words.data(), sizeof(T));
+                if (!f(static_cast<const T &>(value))) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        std::vector<std::array<std::atomic<uint64_t>, s_words>> m_elements;
+        std::atomic<uint64_t> m_announced{0}; // positions that are being or have been written
+        std::atomic<uint64_t> m_committed{0}; // positions that have been written
+    };
+
+    struct sample {
+        uint64_t value;
+        int64_t time; // nanoseconds of std::chrono::steady_clock
+    };
+
+    /**
+     * @brief Minimum, maximum and mean of the samples of an interval starting at time.
+     */
+    struct aggregate {
+        int64_t time;
+        uint64_t min;
+        uint64_t max;
+        double mean;
+        uint64_t count;
+    };
+
+    enum class resolution : int { RAW = 0, SECOND, MINUTE };
+
+    /**
+     * @brief History of a property in multiple resolutions.
+     *
+     * Raw samples are kept for the last raw_capacity samples, aggregates of complete seconds and
+     * minutes for the last 10 minutes and 24 hours. Appending is O(1), window queries visit only
+     * the entries of the window.
+     */
+    class TimeSeries
+    {
+    public:
+        static constexpr size_t raw_capacity = 1024;
+        static constexpr size_t second_capacity = 600;
+        static constexpr size_t minute_capacity = 1440;
+
+        /**
+         * @brief Appends a sample, times must not decrease (single writer).
+         */
+        void append(const sample &s);
+
+        /**
+         * @brief Returns the raw samples of the last window, oldest first.
+         */
+        std::vector<sample> history(std::chrono::nanoseconds window) const;
+
+        /**
+         * @brief Returns the complete aggregates of resolution r (SECOND or MINUTE) that start in the last window, oldest first.
+         */
+        std::vector<aggregate> history(std::chrono::nanoseconds window, resolution r) const;
+
+        /**
+         * @brief Combines the samples of the last window in resolution r.
+         *
+         * Coarser resolutions cover longer windows, but only complete seconds or minutes.
+         *
+         * @return The statistics or std::nullopt if there is no sample in the window
+         */
+        std::optional<aggregate> statistics(std::chrono::nanoseconds window, resolution r = resolution::RAW) const;
+
+    private:
+        struct open_aggregate {
+            aggregate value{};
+            double sum{};
+
+            void add(const sample &s, int64_t start);
+        };
+
+        RingBuffer<sample> m_raw{raw_capacity};
+        RingBuffer<aggregate> m_seconds{second_capacity};
+        RingBuffer<aggregate> m_minutes{minute_capacity};
+
+        /* intervals that are not complete yet, only accessed by the writer */
+        open_aggregate m_second{};
+        open_aggregate m_minute{};
+    };
+}
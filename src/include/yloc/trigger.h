@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <yloc/graph.h>
+
+namespace yloc
+{
+    /**
+     * @brief Bounded lock-free queue for a single producer and a single consumer.
+     */
+    template <class T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue(size_t capacity) : m_elements(capacity + 1) {}
+
+        /**
+         * @return false if the queue is full and value was dropped.
+         */
+        bool push(const T &value)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            size_t next = (tail + 1) % m_elements.size();
+            if (next == m_head.load(std::memory_order_acquire)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            m_elements[tail] = value;
+            m_tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+        std::optional<T> pop()
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire)) {
+                return {};
+            }
+            T value = m_elements[head];
+            m_head.store((head + 1) % m_elements.size(), std::memory_order_release);
+            return value;
+        }
+
+        /**
+         * @return Number of values dropped because the queue was full.
+         */
+        uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<T> m_elements;
+        std::atomic<size_t> m_head{0};
+        std::atomic<size_t> m_tail{0};
+        std::atomic<uint64_t> m_dropped{0};
+    };
+
+    enum class trigger_condition : int {
+        ABOVE = 0, /**< active while the value is above the threshold */
+        BELOW      /**< active while the value is below the threshold */
+    };
+
+    struct trigger_event {
+        vertex_descriptor_t vd;
+        uint64_t value;
+        int64_t time; // nanoseconds of std::chrono::steady_clock
+        bool active;  // true if the condition became true, false if it was cleared
+    };
+
+    /**
+     * @brief Threshold condition with hysteresis on a sampled property of a set of vertices.
+     *
+     * Evaluated by the sampler as values arrive. Events are only emitted on transitions: when
+     * the condition becomes true, and when the value is back by more than the hysteresis on the
+     * other side of the threshold, so values that oscillate around the threshold do not flood.
+     */
+    class Trigger
+    {
+    public:
+        using callback_t = std::function<void(const trigger_event &)>;
+
+        Trigger(const Graph &g, const std::vector<vertex_descriptor_t> &vertices, size_t property, trigger_condition condition,
+                uint64_t threshold, uint64_t hysteresis, callback_t callback, size_t queue_capacity);
+
+        /**
+         * @brief Returns the next event of a trigger without callback (single consumer).
+         */
+        std::optional<trigger_event> poll() { return m_events.pop(); }
+
+        /**
+         * @return Number of events dropped because they were not polled in time.
+         */
+        uint64_t dropped() const { return m_events.dropped(); }
+
+        bool is_active(vertex_descriptor_t vd) const { return vd < m_states.size() && m_states[vd].load(std::memory_order_relaxed) == ACTIVE; }
+
+        /**
+         * @brief Evaluates a new sample of vertex vd (called by the sampler, serialized).
+         */
+        void update(vertex_descriptor_t vd, uint64_t value, int64_t time);
+
+        bool is_member(vertex_descriptor_t vd) const { return vd < m_states.size() && m_states[vd].load(std::memory_order_relaxed) != NONE; }
+
+        const Graph &graph() const { return m_graph; }
+
+        size_t property() const { return m_property; }
+
+    private:
+        enum : uint8_t { NONE = 0, INACTIVE, ACTIVE };
+
+        const Graph &m_graph;
+        size_t m_property;
+        trigger_condition m_condition;
+        uint64_t m_threshold;
+        uint64_t m_hysteresis;
+        callback_t m_callback;
+        SpscQueue<trigger_event> m_events;
+        std::vector<std::atomic<uint8_t>> m_states;
+    };
+
+    /**
+     * @brief Registers a trigger on sampled property of vertices.
+     *
+     * Current samples are evaluated immediately. Without callback, events are queued (up to
+     * queue_capacity) for Trigger::poll(), otherwise the callback is called on a sampler thread
+     * and must not block.
+     *
+     * E.g. power above 300 W, cleared below 290 W, of all GPUs:
+     *   add_trigger(g, gpus, "power", trigger_condition::ABOVE, 300000000, 10000000);
+     *
+     * @return The trigger or nullptr if property is not sampled (see dynamic_properties())
+     */
+    Trigger *add_trigger(const Graph &g, const std::vector<vertex_descriptor_t> &vertices, std::string_view property, trigger_condition condition,
+                         uint64_t threshold, uint64_t hysteresis, Trigger::callback_t callback = {}, size_t queue_capacity = 1024);
+
+    /**
+     * @brief Evaluates a changed sample of property of vertex vd for all triggers of graph g (called by the sampler).
+     */
+    void update_triggers(const Graph &g, vertex_descriptor_t vd, size_t property, uint64_t value, int64_t time);
+}
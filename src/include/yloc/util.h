@@ -5,6 +5,7 @@
 
 #include <boost/graph/graph_utility.hpp> // print_graph
 #include <boost/graph/graphviz.hpp>      // write_graphviz
+#include <boost/property_map/function_property_map.hpp>
 #include <boost/property_map/property_map.hpp>
 
 #include <iostream>
@@ -60,13 +61,13 @@ namespace yloc
             },
             boost::get(boost::vertex_index, g));
 
-        auto epmt = boost::make_transform_value_property_map(
-            [&](yloc::edge_type edgetype) {
+        // edges are partly virtual (see yloc::Graph), so their type is read through g[e]
+        auto epmt = boost::make_function_property_map<yloc::edge_descriptor_t>(
+            [&](yloc::edge_descriptor_t e) {
                 std::stringstream ss;
-                ss << ((edgetype == edge_type::PARENT) ? "parent" : "child");
+                ss << ((g[e].type == edge_type::PARENT) ? "parent" : "child");
                 return ss.str();
-            },
-            boost::get(&yloc::Edge::type, g));
+            });
 
         boost::write_graphviz(ofs, g, boost::make_label_writer(vpmt), boost::make_label_writer(epmt));
     }
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -8,6 +12,7 @@
 #include <yloc/component_types.h>
 #include <yloc/modules/adapter.h>
 #include <yloc/modules/property.h>
+#include <yloc/worker_pool.h>
 
 namespace yloc
 {
@@ -49,13 +54,56 @@ namespace yloc
             return {};
         }
 
-        std::string to_string() const { return std::string{type->to_string()} + ": " + m_description; }
+        /**
+         * @brief Reads a property on a worker thread (see async_workers()), e.g. a blocking device counter.
+         *
+         * The read is skipped (std::nullopt) if it cannot start before deadline because the
+         * workers are busy. The vertex must not be moved (by adding vertices) until the future is ready.
+         */
+        template <class RT>
+        std::future<std::optional<RT>> get_async(std::string_view property_name, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) const
+        {
+            auto promise = std::make_shared<std::promise<std::optional<RT>>>();
+            auto future = promise->get_future();
+            async_workers().submit([this, name = std::string{property_name}, deadline, promise] {
+                try {
+                    promise->set_value(std::chrono::steady_clock::now() < deadline ? get<RT>(name) : std::nullopt);
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+            return future;
+        }
+
+        /**
+         * @brief Returns m_description or, if it is empty, the description kept by an adapter.
+         */
+        std::string_view description() const
+        {
+            if (!m_description.empty()) {
+                return m_description;
+            }
+            for (Adapter *a : m_adapters) {
+                std::string_view description = a->description();
+                if (!description.empty()) {
+                    return description;
+                }
+            }
+            return {};
+        }
+
+        std::string to_string() const { return std::string{type->to_string()} + ": " + std::string{description()}; }
 
         void add_adapter(Adapter *a)
         {
             m_adapters.push_back(a);
         }
 
+        void remove_adapter(Adapter *a)
+        {
+            m_adapters.erase(std::remove(m_adapters.begin(), m_adapters.end(), a), m_adapters.end());
+        }
+
         std::vector<Adapter *> m_adapters{};
         std::string m_description{};
     };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace yloc
+{
+    /**
+     * @brief Pool of threads for blocking adapter calls, e.g. asynchronous property reads.
+     *
+     * Threads are started with the first task, so programs without asynchronous reads do not
+     * create them.
+     */
+    class WorkerPool
+    {
+    public:
+        explicit WorkerPool(size_t num_threads) : m_num_threads{num_threads} {}
+
+        ~WorkerPool() { stop(); }
+
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief Runs the remaining tasks and joins the threads, later tasks start them again.
+         */
+        void stop();
+
+        size_t num_threads() const { return m_num_threads; }
+
+    private:
+        void run();
+
+        size_t m_num_threads;
+        std::vector<std::thread> m_threads{};
+        std::deque<std::function<void()>> m_tasks{};
+        std::mutex m_mutex{};
+        std::condition_variable m_cv{};
+        bool m_stop{false};
+    };
+
+    /**
+     * @brief Returns the pool of asynchronous property reads.
+     *
+     * It has YLOC_ASYNC_THREADS threads, by default as many as hardware threads but at most 8,
+     * so that the library does not occupy the cores of the application on large nodes.
+     */
+    WorkerPool &async_workers();
+}
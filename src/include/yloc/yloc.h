@@ -13,9 +13,19 @@
  */
 
 #include <yloc/affinity.h>
+#include <yloc/async.h>           // asynchronous property reads
+#include <yloc/change_feed.h>     // export of changed property values
 #include <yloc/component_types.h> // is-a vertex/edge type relationship
 #include <yloc/graph.h>           // graph object and underlying boost graph
+#include <yloc/hostname_hierarchy.h> // system hierarchy from hostnames
 #include <yloc/init.h>            // initialization / memory reclamation
+#include <yloc/mapping.h>         // topology-aware process mapping
+#include <yloc/node_template.h>   // shared subgraphs of identical machines
 #include <yloc/query.h>           // simplified graph queries
+#include <yloc/replay.h>          // playback of recorded samples
+#include <yloc/rollup.h>          // aggregates of sampled properties per subtree
+#include <yloc/sampling.h>        // background sampling of dynamic properties
+#include <yloc/series_file.h>     // compressed time-series files of samples
+#include <yloc/trigger.h>         // threshold triggers on sampled properties
 #include <yloc/util.h>            // utility functions
 #include <yloc/status.h>     // required ?
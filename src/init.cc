@@ -1,7 +1,29 @@
 #include <yloc/graph.h>
 #include <yloc/init.h>
 #include <yloc/modules/module.h>
+#include <yloc/sampling.h>
+#include <yloc/series_file.h>
+#include <yloc/snapshot.h>
 #include <yloc/status.h>
+#include <yloc/worker_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace yloc
 {
@@ -11,20 +33,244 @@ namespace yloc
         return s_graph;
     }
 
-    yloc_status_t init()
+    static int s_init_flags{YLOC_FULL};
+
+    int init_flags()
+    {
+        return s_init_flags;
+    }
+
+    /* background sampling of the modules with an update interval (YLOC_ONGOING) */
+    static std::unique_ptr<Sampler> s_sampler{};
+
+    /* control block in front of the snapshot in a shared memory segment */
+    struct shared_segment {
+        enum : uint32_t { BUILDING = 0,
+                          READY,
+                          FAILED };
+        std::atomic<uint32_t> state;
+        int32_t creator; // pid of the process that builds the snapshot
+        int32_t flags;   // init flags of the creator
+        uint32_t padding;
+        uint64_t size;
+    };
+
+    /* name of the segment created by this process, removed in finalize() */
+    static std::string s_created_segment{};
+
+    /* identifier of the job from the environment of common launchers, empty if there is none */
+    static std::string job_identity()
+    {
+        for (const char *variable : {"SLURM_JOB_ID", "PMIX_NAMESPACE", "OMPI_MCA_ess_base_jobid", "PMI_JOBID", "PALS_APID", "PBS_JOBID", "LSB_JOBID"}) {
+            const char *value = std::getenv(variable);
+            if (value != nullptr && *value != '\0') {
+                std::string id{value};
+                if (const char *step = std::strcmp(variable, "SLURM_JOB_ID") == 0 ? std::getenv("SLURM_STEP_ID") : nullptr) {
+                    id += "." + std::string{step};
+                }
+                // shm names must not contain further slashes
+                std::replace_if(id.begin(), id.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '.'; }, '_');
+                return id;
+            }
+        }
+        return {};
+    }
+
+    static std::string shared_segment_name()
+    {
+        const char *name = std::getenv("YLOC_SHM_NAME");
+        if (name != nullptr) {
+            return name;
+        }
+        char hostname[HOST_NAME_MAX];
+        gethostname(hostname, HOST_NAME_MAX);
+        std::string job = job_identity();
+        return "/yloc-" + std::string{hostname} + "-" + std::to_string(getuid()) + (job.empty() ? "" : "-" + job);
+    }
+
+    /* time to wait for the snapshot of another process in milliseconds */
+    static long shared_segment_timeout()
+    {
+        const char *timeout = std::getenv("YLOC_SHM_TIMEOUT");
+        return timeout != nullptr ? std::strtol(timeout, nullptr, 10) : 10000;
+    }
+
+    /* removes segment name unless it was already replaced by a segment other than the one open as fd */
+    static void unlink_shared_segment(const std::string &name, int fd)
+    {
+        struct stat opened, current;
+        int current_fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (current_fd < 0) {
+            return;
+        }
+        if (fstat(fd, &opened) == 0 && fstat(current_fd, &current) == 0 && opened.st_ino == current.st_ino) {
+            shm_unlink(name.c_str());
+        }
+        close(current_fd);
+    }
+
+    /* runs the shareable modules and publishes a snapshot of the graph in the new segment fd */
+    static bool create_shared_graph(Graph &g, const std::vector<Module *> &modules, int fd, const std::string &name)
     {
+        s_created_segment = name;
+        auto *segment = static_cast<shared_segment *>(MAP_FAILED);
+        if (ftruncate(fd, sizeof(shared_segment)) == 0) {
+            segment = static_cast<shared_segment *>(mmap(nullptr, sizeof(shared_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        }
+        if (segment != MAP_FAILED) {
+            segment->creator = static_cast<int32_t>(getpid());
+            segment->flags = s_init_flags;
+        }
+
+        for (auto *m : modules) {
+            if (m->m_enabled && m->m_shareable) {
+                m->init_graph(g);
+            }
+        }
+        if (segment == MAP_FAILED) {
+            close(fd);
+            return true;
+        }
+
+        std::vector<char> snapshot = make_snapshot(g);
+        size_t size = sizeof(shared_segment) + snapshot.size();
+        void *data = MAP_FAILED;
+        if (ftruncate(fd, size) == 0) {
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (data != MAP_FAILED) {
+            std::memcpy(static_cast<char *>(data) + sizeof(shared_segment), snapshot.data(), snapshot.size());
+            segment->size = snapshot.size();
+            munmap(data, size);
+        }
+        segment->state.store(data != MAP_FAILED ? shared_segment::READY : shared_segment::FAILED, std::memory_order_release);
+        munmap(segment, sizeof(shared_segment));
+        close(fd);
+        return true;
+    }
+
+    enum class attach_result { ATTACHED, STALE, FAILED };
+
+    /**
+     * @brief Waits for the snapshot of another process and loads it, the mapping is kept for the lifetime of the graph.
+     *
+     * Segments whose creator exited (e.g. was killed before finalize()) are stale, segments of
+     * creators with other init flags are not used. Stale, failed and timed out segments are removed.
+     */
+    static attach_result attach_shared_graph(Graph &g, const std::string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return attach_result::STALE; // removed in the meantime
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{shared_segment_timeout()};
+        const shared_segment *segment = nullptr;
+        uint32_t state = shared_segment::BUILDING;
+        bool stale = false;
+        while (std::chrono::steady_clock::now() < deadline) {
+            struct stat st;
+            if (segment == nullptr && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(shared_segment)) {
+                void *data = mmap(nullptr, sizeof(shared_segment), PROT_READ, MAP_SHARED, fd, 0);
+                segment = data != MAP_FAILED ? static_cast<const shared_segment *>(data) : nullptr;
+            }
+            if (segment != nullptr) {
+                state = segment->state.load(std::memory_order_acquire);
+                pid_t creator = segment->creator;
+                stale = creator > 0 && kill(creator, 0) != 0 && errno == ESRCH;
+                if (state != shared_segment::BUILDING || stale) {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        attach_result result = stale ? attach_result::STALE : attach_result::FAILED;
+        if (!stale && state == shared_segment::READY && segment->flags == s_init_flags) {
+            size_t size = sizeof(shared_segment) + segment->size;
+            void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            vertex_descriptor_t root;
+            if (data != MAP_FAILED) {
+                if (load_snapshot(g, static_cast<const char *>(data) + sizeof(shared_segment), segment->size, &root) == YLOC_STATUS_SUCCESS) {
+                    g.set_root_vertex(root);
+                    result = attach_result::ATTACHED;
+                } else {
+                    munmap(data, size);
+                }
+            }
+        }
+        if (stale || state != shared_segment::READY) {
+            unlink_shared_segment(name, fd);
+        }
+        if (segment != nullptr) {
+            munmap(const_cast<shared_segment *>(segment), sizeof(shared_segment));
+        }
+        close(fd);
+        return result;
+    }
+
+    /**
+     * @brief Initializes the shareable modules through a node-wide shared memory snapshot.
+     *
+     * The first process of a node creates the segment, runs the shareable modules and publishes a
+     * snapshot of the graph. The other processes load the snapshot instead of running these modules.
+     * The segment name contains the job id of the launcher, if any, so that jobs do not share segments.
+     *
+     * @return true if the shareable modules are initialized, false to fall back to running them locally
+     */
+    static bool init_shared_modules(Graph &g, const std::vector<Module *> &modules)
+    {
+        std::string name = shared_segment_name();
+        // a stale segment is removed by the first attempt, the second one creates a new segment
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd >= 0) {
+                return create_shared_graph(g, modules, fd, name);
+            } else if (errno != EEXIST) {
+                return false;
+            }
+            attach_result result = attach_shared_graph(g, name);
+            if (result != attach_result::STALE) {
+                return result == attach_result::ATTACHED;
+            }
+        }
+        return false;
+    }
+
+    yloc_status_t init(int flags)
+    {
+        s_init_flags = flags;
+
         auto modules = list_modules(); // list_modules creates new vector ...
 
         std::sort(modules.begin(), modules.end(), [](yloc::Module *a, yloc::Module *b) {
             return a->m_init_order < b->m_init_order;
         });
 
+        // a graph restricted to the binding of the process differs between the processes of a node and cannot be shared
+        bool shared = (flags & YLOC_SHARED) && !(flags & YLOC_BOUND) && init_shared_modules(root_graph(), modules);
+
         for (auto *m : modules) {
-            if (m->m_enabled) {
+            if (m->m_enabled && !(shared && m->m_shareable)) {
                 // TODO: check return value
                 m->init_graph(root_graph());
             }
         }
+
+        if (flags & YLOC_ONGOING) {
+            const char *interval = std::getenv("YLOC_SAMPLING_INTERVAL");
+            for (auto *m : modules) {
+                if (interval != nullptr && m->m_update_interval.count() > 0) {
+                    m->m_update_interval = std::chrono::milliseconds{std::max(1L, std::strtol(interval, nullptr, 10))};
+                }
+            }
+            const char *sample_file = std::getenv("YLOC_SAMPLE_FILE");
+            if (sample_file != nullptr && *sample_file != '\0') {
+                start_recording(root_graph(), sample_file);
+            }
+            s_sampler = std::make_unique<Sampler>(root_graph(), modules);
+            s_sampler->start();
+        }
         return YLOC_STATUS_SUCCESS;
     }
 
@@ -32,7 +278,15 @@ namespace yloc
     {
         // free modules ?
 
-        // exit threads of ongoing modules (nothing to do yet)
+        // exit threads of ongoing modules
+        s_sampler.reset();
+        stop_recording();
+        async_workers().stop();
+
+        if (!s_created_segment.empty()) {
+            shm_unlink(s_created_segment.c_str());
+            s_created_segment.clear();
+        }
 
         return YLOC_STATUS_SUCCESS;
     }
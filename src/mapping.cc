@@ -0,0 +1,201 @@
+#include <yloc/mapping.h>
+#include <yloc/node_template.h>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+namespace yloc
+{
+    static constexpr uint64_t s_unreachable = std::numeric_limits<uint64_t>::max();
+
+    /* number of hops from vertex from to every vertex of graph g */
+    static void bfs_hops(const Graph &g, vertex_descriptor_t from, std::vector<uint64_t> &hops)
+    {
+        hops.assign(boost::num_vertices(g), s_unreachable);
+        hops[from] = 0;
+        auto hops_pmap = boost::make_iterator_property_map(hops.begin(), boost::get(boost::vertex_index, g));
+        boost::breadth_first_search(g, from, boost::visitor(boost::make_bfs_visitor(boost::record_distances(hops_pmap, boost::on_tree_edge()))));
+    }
+
+    std::vector<uint64_t> hop_distances(const Graph &g, const std::vector<vertex_descriptor_t> &vertices)
+    {
+        size_t n = vertices.size();
+        std::vector<uint64_t> dist(n * n, s_unreachable);
+        std::vector<uint64_t> hops{}, template_hops{};
+        uint64_t max_hops = 0;
+
+        // a vertex in a template instance is as far below its machine vertex as its location below the template root
+        std::vector<std::optional<instance_vertex>> locations(n);
+        std::vector<uint64_t> depths(n, 0);
+        std::unordered_map<const NodeTemplate *, std::vector<uint64_t>> root_hops{};
+        for (size_t i = 0; i < n; ++i) {
+            locations[i] = locate_in_instance(g, vertices[i]);
+            if (locations[i].has_value()) {
+                const NodeTemplate &node_template = g.template_instance(locations[i]->machine)->node_template();
+                auto &from_root = root_hops[&node_template];
+                if (from_root.empty()) {
+                    bfs_hops(node_template.graph, node_template.graph.get_root_vertex(), from_root);
+                }
+                depths[i] = from_root[locations[i]->vd];
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            bfs_hops(g, vertices[i], hops);
+            template_hops.clear();
+            for (size_t j = 0; j < n; ++j) {
+                uint64_t d = hops[vertices[j]];
+                if (d == s_unreachable) {
+                    continue;
+                }
+                if (locations[i].has_value() && locations[j].has_value() && locations[i]->machine == locations[j]->machine) {
+                    // both are reached through the machine vertex, the path between them stays inside the template
+                    if (template_hops.empty()) {
+                        bfs_hops(g.template_instance(locations[i]->machine)->graph(), locations[i]->vd, template_hops);
+                    }
+                    if (template_hops[locations[j]->vd] == s_unreachable) {
+                        continue;
+                    }
+                    d += template_hops[locations[j]->vd];
+                } else {
+                    d += depths[i] + depths[j];
+                }
+                dist[i * n + j] = d;
+                max_hops = std::max(max_hops, d);
+            }
+        }
+
+        std::replace(dist.begin(), dist.end(), s_unreachable, 2 * max_hops + 2);
+        return dist;
+    }
+
+    uint64_t mapping_cost(const std::vector<uint64_t> &comm, const std::vector<uint64_t> &dist, const std::vector<int> &perm)
+    {
+        size_t n = perm.size();
+        uint64_t cost = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                cost += comm[i * n + j] * dist[perm[i] * n + perm[j]];
+            }
+        }
+        return cost;
+    }
+
+    /* change of the mapping cost if processes a and b exchange their slots */
+    static int64_t swap_delta(const std::vector<uint64_t> &comm, const std::vector<uint64_t> &dist, const std::vector<int> &perm, size_t a, size_t b)
+    {
+        size_t n = perm.size();
+        size_t sa = perm[a], sb = perm[b];
+        int64_t delta = 0;
+        for (size_t k = 0; k < n; ++k) {
+            if (k == a || k == b) {
+                continue;
+            }
+            size_t sk = perm[k];
+            int64_t weight_a = comm[a * n + k] + comm[k * n + a];
+            int64_t weight_b = comm[b * n + k] + comm[k * n + b];
+            int64_t dist_a = dist[sa * n + sk];
+            int64_t dist_b = dist[sb * n + sk];
+            delta += (weight_a - weight_b) * (dist_b - dist_a);
+        }
+        return delta;
+    }
+
+    std::vector<int> map_processes(const std::vector<uint64_t> &comm, const std::vector<uint64_t> &dist, int max_passes)
+    {
+        size_t n = static_cast<size_t>(std::sqrt(static_cast<double>(comm.size())));
+        std::vector<int> perm(n, -1);
+        if (n == 0 || n * n != comm.size() || dist.size() != comm.size()) {
+            return {};
+        }
+
+        // symmetric communication volume between processes
+        std::vector<uint64_t> volume(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                volume[i] += comm[i * n + j] + comm[j * n + i];
+            }
+        }
+
+        std::vector<bool> slot_used(n, false);
+        std::vector<uint64_t> affinity(n, 0); // communication of unplaced processes to the placed ones
+        std::vector<size_t> placed{};
+
+        // start with the heaviest process on the most central slot
+        size_t first = std::max_element(volume.begin(), volume.end()) - volume.begin();
+        size_t central = 0;
+        uint64_t central_sum = std::numeric_limits<uint64_t>::max();
+        for (size_t s = 0; s < n; ++s) {
+            uint64_t sum = 0;
+            for (size_t t = 0; t < n; ++t) {
+                sum += dist[s * n + t];
+            }
+            if (sum < central_sum) {
+                central = s;
+                central_sum = sum;
+            }
+        }
+
+        size_t next = first;
+        size_t slot = central;
+        while (true) {
+            perm[next] = static_cast<int>(slot);
+            slot_used[slot] = true;
+            placed.push_back(next);
+            if (placed.size() == n) {
+                break;
+            }
+            for (size_t k = 0; k < n; ++k) {
+                affinity[k] += comm[next * n + k] + comm[k * n + next];
+            }
+
+            // unplaced process with the most communication to placed processes, ties broken by volume
+            next = n;
+            for (size_t k = 0; k < n; ++k) {
+                if (perm[k] < 0 && (next == n || affinity[k] > affinity[next] || (affinity[k] == affinity[next] && volume[k] > volume[next]))) {
+                    next = k;
+                }
+            }
+
+            // free slot with the lowest weighted distance to the communication partners of next
+            slot = n;
+            uint64_t slot_cost = std::numeric_limits<uint64_t>::max();
+            for (size_t s = 0; s < n; ++s) {
+                if (slot_used[s]) {
+                    continue;
+                }
+                uint64_t cost = 0;
+                for (size_t q : placed) {
+                    cost += (comm[next * n + q] + comm[q * n + next]) * dist[s * n + perm[q]];
+                }
+                if (cost < slot_cost) {
+                    slot = s;
+                    slot_cost = cost;
+                }
+            }
+        }
+
+        // refinement by pairwise swaps
+        for (int pass = 0; pass < max_passes; ++pass) {
+            bool improved = false;
+            for (size_t a = 0; a < n; ++a) {
+                for (size_t b = a + 1; b < n; ++b) {
+                    if (swap_delta(comm, dist, perm, a, b) < 0) {
+                        std::swap(perm[a], perm[b]);
+                        improved = true;
+                    }
+                }
+            }
+            if (!improved) {
+                break;
+            }
+        }
+        return perm;
+    }
+}
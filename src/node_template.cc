@@ -0,0 +1,138 @@
+#include <yloc/node_template.h>
+#include <yloc/snapshot.h>
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+namespace yloc
+{
+    static uint64_t hash_combine(uint64_t seed, uint64_t value)
+    {
+        // mixing function of splitmix64
+        uint64_t x = seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    /* hash of the type and the static properties of a single vertex */
+    static uint64_t vertex_hash(const Vertex &v)
+    {
+        uint64_t hash = std::hash<std::string_view>{}(v.type->to_string());
+        for (auto name : static_properties()) {
+            auto value = v.get<uint64_t>(name);
+            hash = hash_combine(hash, value.has_value() ? value.value() + 1 : 0);
+        }
+        auto mask = v.get<AffinityMask>("cpu_affinity_mask");
+        if (mask.has_value()) {
+            hash = hash_combine(hash, std::hash<std::bitset<NPROCESSORS_ONLN>>{}(mask.value()));
+        }
+        return hash;
+    }
+
+    uint64_t subtree_hash(const Graph &g, vertex_descriptor_t root)
+    {
+        // iterative post-order traversal, hardware trees can be deep (e.g. PCI hierarchies)
+        std::vector<uint64_t> hashes(boost::num_vertices(g), 0);
+        std::vector<std::pair<vertex_descriptor_t, bool>> stack{{root, false}};
+        std::vector<bool> visited(boost::num_vertices(g), false);
+        visited[root] = true;
+
+        auto children = [&](vertex_descriptor_t vd, auto &&fn) {
+            for (auto e : boost::make_iterator_range(boost::out_edges(vd, g))) {
+                vertex_descriptor_t child = boost::target(e, g);
+                if (g[e].type == edge_type::CHILD && !g[child].type->is_a<LogicalComponent>()) {
+                    fn(child);
+                }
+            }
+        };
+
+        while (!stack.empty()) {
+            auto [vd, expanded] = stack.back();
+            stack.pop_back();
+            if (!expanded) {
+                stack.push_back({vd, true});
+                children(vd, [&](vertex_descriptor_t child) {
+                    if (!visited[child]) {
+                        visited[child] = true;
+                        stack.push_back({child, false});
+                    }
+                });
+                continue;
+            }
+
+            std::vector<uint64_t> child_hashes{};
+            children(vd, [&](vertex_descriptor_t child) { child_hashes.push_back(hashes[child]); });
+            std::sort(child_hashes.begin(), child_hashes.end());
+
+            uint64_t hash = vertex_hash(g[vd]);
+            for (uint64_t child_hash : child_hashes) {
+                hash = hash_combine(hash, child_hash);
+            }
+            hashes[vd] = hash_combine(hash, child_hashes.size());
+        }
+        return hashes[root];
+    }
+
+    uint64_t snapshot_hash(const std::vector<char> &snapshot)
+    {
+        return std::hash<std::string_view>{}(std::string_view{snapshot.data(), snapshot.size()});
+    }
+
+    std::shared_ptr<const NodeTemplate> make_node_template(std::vector<char> snapshot)
+    {
+        auto node_template = std::make_shared<NodeTemplate>();
+        node_template->snapshot = std::move(snapshot);
+        vertex_descriptor_t root;
+        if (load_snapshot(node_template->graph, node_template->snapshot.data(), node_template->snapshot.size(), &root) != YLOC_STATUS_SUCCESS) {
+            return nullptr;
+        }
+        node_template->graph.set_root_vertex(root);
+        node_template->hash = subtree_hash(node_template->graph, root);
+        return node_template;
+    }
+
+    TemplateInstance *add_template_instance(Graph &g, vertex_descriptor_t vd, std::shared_ptr<const NodeTemplate> node_template)
+    {
+        const Vertex &root = node_template->graph[node_template->graph.get_root_vertex()];
+        if (g[vd].type == UnknownComponentType::ptr()) {
+            g[vd].type = root.type;
+        }
+        // the adapters of the template root are shared, they live as long as the instance
+        for (Adapter *a : root.m_adapters) {
+            g[vd].add_adapter(a);
+        }
+        auto instance = std::make_shared<TemplateInstance>(std::move(node_template));
+        g.set_template_instance(vd, instance);
+        return instance.get();
+    }
+
+    std::optional<instance_vertex> locate_in_instance(const Graph &g, vertex_descriptor_t vd)
+    {
+        if (TemplateInstance *instance = g.template_instance(vd)) {
+            return instance_vertex{vd, instance->graph().get_root_vertex()};
+        }
+        auto parent = g.parent(vd);
+        TemplateInstance *instance = parent.has_value() ? g.template_instance(parent.value()) : nullptr;
+        auto location = instance != nullptr ? instance->location(vd) : std::nullopt;
+        if (location.has_value()) {
+            return instance_vertex{parent.value(), location.value()};
+        }
+        return {};
+    }
+
+    yloc_status_t expand_template_instance(Graph &g, vertex_descriptor_t vd, const std::string &prefix)
+    {
+        TemplateInstance *instance = g.template_instance(vd);
+        if (instance == nullptr) {
+            return YLOC_STATUS_NOT_FOUND;
+        }
+        // the copy brings its own root adapter
+        for (Adapter *a : instance->graph()[instance->graph().get_root_vertex()].m_adapters) {
+            g[vd].remove_adapter(a);
+        }
+        const auto &snapshot = instance->node_template().snapshot;
+        return load_snapshot_at(g, vd, prefix, snapshot.data(), snapshot.size());
+    }
+}
@@ -0,0 +1,152 @@
+#include <yloc/affinity.h>
+#include <yloc/query.h>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace yloc
+{
+    /* affinity mask of vertex v or of its closest ancestor that has one */
+    static std::optional<AffinityMask> locality_mask(const Graph &g, vertex_descriptor_t v)
+    {
+        while (true) {
+            auto mask = g[v].get<AffinityMask>("cpu_affinity_mask");
+            if (mask.has_value()) {
+                return mask;
+            }
+            std::optional<vertex_descriptor_t> parent{};
+            for (auto e : boost::make_iterator_range(boost::out_edges(v, g))) {
+                if (g[e].type == edge_type::PARENT) {
+                    parent = boost::target(e, g);
+                    break;
+                }
+            }
+            if (!parent.has_value()) {
+                return {};
+            }
+            v = parent.value();
+        }
+    }
+
+    /* row of the table that is used as origin for queries from vertex v */
+    static std::optional<size_t> origin_index(const Graph &g, const DistanceTable &table, vertex_descriptor_t v)
+    {
+        auto index = table.index(v);
+        if (index.has_value()) {
+            return index;
+        }
+
+        auto mask = locality_mask(g, v);
+        if (!mask.has_value()) {
+            return {};
+        }
+
+        std::optional<size_t> origin{};
+        size_t origin_count = 0;
+        const auto &vertices = table.vertices();
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto candidate = g[vertices[i]].get<AffinityMask>("cpu_affinity_mask");
+            if (!candidate.has_value() || !candidate.value().any() || !candidate.value().is_containing(mask.value())) {
+                continue;
+            }
+            if (!origin.has_value() || candidate.value().count() < origin_count) {
+                origin = i;
+                origin_count = candidate.value().count();
+            }
+        }
+        return origin;
+    }
+
+    std::vector<vertex_descriptor_t> ordered_by_distance(const Graph &g, vertex_descriptor_t v, const std::string &table_name)
+    {
+        const DistanceTable *table = g.distance_table(table_name);
+        if (table == nullptr) {
+            return {};
+        }
+
+        auto origin = origin_index(g, *table, v);
+        if (!origin.has_value()) {
+            return {};
+        }
+
+        // unknown distances are sorted to the end
+        std::vector<size_t> order(table->vertices().size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            auto value_a = table->value(origin.value(), a);
+            auto value_b = table->value(origin.value(), b);
+            if (!value_b.has_value()) {
+                return value_a.has_value();
+            }
+            return value_a.has_value() && table->is_closer(value_a.value(), value_b.value());
+        });
+
+        std::vector<vertex_descriptor_t> result{};
+        result.reserve(order.size());
+        for (size_t i : order) {
+            result.push_back(table->vertices()[i]);
+        }
+        return result;
+    }
+
+    std::optional<vertex_descriptor_t> best_memory_target(const Graph &g, vertex_descriptor_t initiator, DistanceTable::kind metric)
+    {
+        std::vector<std::string> table_names{"memory_bandwidth"};
+        if (metric == DistanceTable::kind::LATENCY) {
+            table_names = {"memory_latency", "numa_latency"};
+        }
+
+        for (const auto &table_name : table_names) {
+            const DistanceTable *table = g.distance_table(table_name);
+            if (table == nullptr) {
+                continue;
+            }
+            auto origin = origin_index(g, *table, initiator);
+            if (!origin.has_value()) {
+                continue;
+            }
+            auto ordered = ordered_by_distance(g, initiator, table_name);
+            if (!ordered.empty() && table->value(origin.value(), table->index(ordered.front()).value()).has_value()) {
+                return ordered.front();
+            }
+        }
+        return {};
+    }
+
+    std::vector<vertex_descriptor_t> most_performant_pus(const Graph &g, vertex_descriptor_t v, size_t n)
+    {
+        std::vector<std::vector<vertex_descriptor_t>> cpu_kinds = g.cpu_kinds();
+        if (cpu_kinds.empty()) {
+            cpu_kinds.emplace_back();
+            for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+                if (g[vd].type->is_a<LogicalCore>()) {
+                    cpu_kinds.back().push_back(vd);
+                }
+            }
+        }
+
+        std::vector<int> hops(boost::num_vertices(g), std::numeric_limits<int>::max());
+        hops[v] = 0;
+        auto hops_pmap = boost::make_iterator_property_map(hops.begin(), boost::get(boost::vertex_index, g));
+        boost::breadth_first_search(g, v, boost::visitor(boost::make_bfs_visitor(boost::record_distances(hops_pmap, boost::on_tree_edge()))));
+
+        std::vector<vertex_descriptor_t> result{};
+        for (auto kind = cpu_kinds.rbegin(); kind != cpu_kinds.rend() && result.size() < n; ++kind) {
+            std::vector<vertex_descriptor_t> pus = *kind;
+            std::stable_sort(pus.begin(), pus.end(), [&](vertex_descriptor_t a, vertex_descriptor_t b) {
+                return hops[a] < hops[b];
+            });
+            for (size_t i = 0; i < pus.size() && result.size() < n; ++i) {
+                result.push_back(pus[i]);
+            }
+        }
+        return result;
+    }
+}
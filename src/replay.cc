@@ -0,0 +1,140 @@
+#include <yloc/replay.h>
+#include <yloc/sampling.h>
+#include <yloc/series_file.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace yloc
+{
+    yloc_status_t Replay::open(const std::string &path)
+    {
+        m_series.clear();
+        m_times.clear();
+        if (read_series_file(path) != YLOC_STATUS_SUCCESS) {
+            yloc_status_t status = read_csv(path);
+            if (status != YLOC_STATUS_SUCCESS) {
+                return status;
+            }
+        }
+
+        for (const auto &s : m_series) {
+            for (const sample &smp : s.samples) {
+                m_times.push_back(smp.time);
+            }
+        }
+        std::sort(m_times.begin(), m_times.end());
+        m_times.erase(std::unique(m_times.begin(), m_times.end()), m_times.end());
+        if (m_times.empty()) {
+            return YLOC_STATUS_NO_DATA;
+        }
+        start(m_speed);
+        return YLOC_STATUS_SUCCESS;
+    }
+
+    yloc_status_t Replay::read_series_file(const std::string &path)
+    {
+        SeriesFileReader reader{};
+        yloc_status_t status = reader.open(path);
+        if (status != YLOC_STATUS_SUCCESS) {
+            return status;
+        }
+        int64_t from = std::numeric_limits<int64_t>::min();
+        int64_t to = std::numeric_limits<int64_t>::max();
+        for (const auto &info : reader.series()) {
+            auto property = dynamic_property_index(info.property);
+            if (property.has_value()) {
+                m_series.push_back({info.vertex, *property, reader.scan(info.id, from, to)});
+            }
+        }
+        return YLOC_STATUS_SUCCESS;
+    }
+
+    yloc_status_t Replay::read_csv(const std::string &path)
+    {
+        std::ifstream file{path};
+        if (!file) {
+            return YLOC_STATUS_INVALID_ARGS;
+        }
+        std::map<std::pair<std::string, size_t>, size_t> index{}; // series by vertex and property
+        std::string line{};
+        while (std::getline(file, line)) {
+            // the vertex may contain commas, the other fields do not
+            size_t first = line.find(',');
+            size_t last = line.rfind(',');
+            size_t middle = last != std::string::npos && last > 0 ? line.rfind(',', last - 1) : std::string::npos;
+            if (first == std::string::npos || middle == std::string::npos || middle <= first) {
+                continue;
+            }
+            char *end;
+            int64_t time = std::strtoll(line.c_str(), &end, 10);
+            if (end != line.c_str() + first) {
+                continue; // header or malformed line
+            }
+            uint64_t value = std::strtoull(line.c_str() + last + 1, &end, 10);
+            if (end == line.c_str() + last + 1) {
+                continue;
+            }
+            auto property = dynamic_property_index(std::string_view{line}.substr(middle + 1, last - middle - 1));
+            if (!property.has_value()) {
+                continue;
+            }
+            std::string vertex = line.substr(first + 1, middle - first - 1);
+            auto iter = index.find({vertex, *property});
+            if (iter == index.end()) {
+                iter = index.emplace(std::make_pair(vertex, *property), m_series.size()).first;
+                m_series.push_back({vertex, *property, {}});
+            }
+            m_series[iter->second].samples.push_back({value, time});
+        }
+        for (auto &s : m_series) {
+            std::stable_sort(s.samples.begin(), s.samples.end(), [](const sample &a, const sample &b) { return a.time < b.time; });
+        }
+        return YLOC_STATUS_SUCCESS;
+    }
+
+    void Replay::start(double speed)
+    {
+        m_speed = speed > 0 ? speed : 0;
+        m_start = std::chrono::steady_clock::now();
+        m_cursor.store(0, std::memory_order_relaxed);
+    }
+
+    int64_t Replay::position() const
+    {
+        if (m_times.empty()) {
+            return 0;
+        }
+        if (m_speed == 0) {
+            return m_times[m_cursor.load(std::memory_order_relaxed)];
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+        int64_t offset = static_cast<int64_t>(static_cast<double>(elapsed.count()) * m_speed);
+        return std::min(m_times.front() + offset, m_times.back());
+    }
+
+    bool Replay::step()
+    {
+        size_t cursor = m_cursor.load(std::memory_order_relaxed);
+        if (m_speed > 0 || cursor + 1 >= m_times.size()) {
+            return false;
+        }
+        m_cursor.store(cursor + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::optional<uint64_t> Replay::value(size_t series) const
+    {
+        const auto &samples = m_series[series].samples;
+        int64_t time = position();
+        auto iter = std::upper_bound(samples.begin(), samples.end(), time, [](int64_t t, const sample &s) { return t < s.time; });
+        if (iter == samples.begin()) {
+            return {};
+        }
+        return std::prev(iter)->value;
+    }
+}
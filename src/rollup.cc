@@ -0,0 +1,127 @@
+#include <yloc/rollup.h>
+#include <yloc/sampling.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace yloc
+{
+    /* all rollups, the mutex also serializes their updates */
+    static std::mutex s_rollups_mutex{};
+    static std::vector<std::unique_ptr<Rollup>> s_rollups{};
+    static std::atomic<size_t> s_num_rollups{0};
+
+    Rollup::Rollup(const Graph &g, std::string name, size_t property, rollup_op op, std::function<bool(const Component *)> is_member)
+        : m_graph{g}, m_name{std::move(name)}, m_property{property}, m_op{op}, m_values(boost::num_vertices(g))
+    {
+        for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+            m_values[vd].member = is_member(g[vd].type);
+        }
+    }
+
+    void Rollup::publish(state &s)
+    {
+        double value = 0;
+        uint64_t count = s.count.load(std::memory_order_relaxed);
+        switch (m_op) {
+        case rollup_op::SUM:
+            value = static_cast<double>(s.sum);
+            break;
+        case rollup_op::MEAN:
+            value = count != 0 ? static_cast<double>(s.sum) / count : 0;
+            break;
+        case rollup_op::MAX:
+            value = static_cast<double>(s.max);
+            break;
+        }
+        s.value.store(value, std::memory_order_relaxed);
+        s.count.store(count, std::memory_order_release);
+    }
+
+    void Rollup::children_max(vertex_descriptor_t vd, uint64_t &max) const
+    {
+        for (vertex_descriptor_t child : m_graph.children(vd)) {
+            if (child >= m_values.size()) {
+                children_max(child, max); // a vertex without state, look through it
+            } else if (m_values[child].count.load(std::memory_order_relaxed) != 0) {
+                max = std::max(max, m_values[child].max);
+            }
+        }
+    }
+
+    void Rollup::update(vertex_descriptor_t vd, uint64_t value)
+    {
+        state &member = m_values[vd];
+        std::optional<uint64_t> previous = member.own;
+        member.own = value;
+        // sums are updated by the difference, modulo 2^64 like the sum itself
+        uint64_t delta = value - previous.value_or(0);
+        bool decreased = previous.has_value() && value < *previous;
+
+        // vertices added after the rollup (e.g. by a topology reload) have no state and are passed over
+        for (std::optional<vertex_descriptor_t> v = vd; v.has_value(); v = m_graph.parent(*v)) {
+            if (*v >= m_values.size()) {
+                continue;
+            }
+            state &s = m_values[*v];
+            s.sum += delta;
+            if (!previous.has_value()) {
+                s.count.store(s.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            if (m_op == rollup_op::MAX && !decreased) {
+                s.max = std::max(s.max, value);
+            } else if (m_op == rollup_op::MAX) {
+                // the previous value may have been the maximum of this subtree
+                uint64_t max = s.own.value_or(0);
+                children_max(*v, max);
+                s.max = max;
+            }
+            publish(s);
+        }
+    }
+
+    const Rollup *add_rollup(const Graph &g, std::string name, std::string_view property, rollup_op op, std::function<bool(const Component *)> is_member)
+    {
+        auto index = dynamic_property_index(property);
+        if (!index.has_value()) {
+            return nullptr;
+        }
+        auto rollup = std::make_unique<Rollup>(g, std::move(name), *index, op, std::move(is_member));
+
+        std::lock_guard<std::mutex> lock{s_rollups_mutex};
+        for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+            const SampledAdapter *sampled = find_sampled_adapter(g[vd]);
+            auto latest = sampled != nullptr ? sampled->latest(*index) : std::nullopt;
+            if (latest.has_value() && rollup->is_member(vd)) {
+                rollup->update(vd, latest->value);
+            }
+        }
+        s_rollups.push_back(std::move(rollup));
+        s_num_rollups.store(s_rollups.size(), std::memory_order_release);
+        return s_rollups.back().get();
+    }
+
+    const Rollup *find_rollup(const Graph &g, std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock{s_rollups_mutex};
+        for (const auto &rollup : s_rollups) {
+            if (&rollup->graph() == &g && rollup->name() == name) {
+                return rollup.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void update_rollups(const Graph &g, vertex_descriptor_t vd, size_t property, uint64_t value)
+    {
+        if (s_num_rollups.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock{s_rollups_mutex};
+        for (const auto &rollup : s_rollups) {
+            if (&rollup->graph() == &g && rollup->property() == property && rollup->is_member(vd)) {
+                rollup->update(vd, value);
+            }
+        }
+    }
+}
@@ -0,0 +1,286 @@
+#include <yloc/modules/module.h>
+#include <yloc/rollup.h>
+#include <yloc/sampling.h>
+#include <yloc/series_file.h>
+#include <yloc/trigger.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+
+#include <time.h>
+
+namespace yloc
+{
+    const std::vector<std::string_view> &dynamic_properties()
+    {
+        static const std::vector<std::string_view> s_properties{
+            "memory_usage", "memory_load", "throughput", "power", "usage", "load",
+            "pci_throughput", "pci_throughput_read", "pci_throughput_write"};
+        return s_properties;
+    }
+
+    std::optional<size_t> dynamic_property_index(std::string_view name)
+    {
+        static const auto s_indices = [] {
+            std::unordered_map<std::string_view, size_t> indices{};
+            for (size_t i = 0; i < dynamic_properties().size(); ++i) {
+                indices[dynamic_properties()[i]] = i;
+            }
+            return indices;
+        }();
+        auto iter = s_indices.find(name);
+        return iter != s_indices.end() ? std::optional<size_t>{iter->second} : std::nullopt;
+    }
+
+    std::shared_mutex &structure_mutex()
+    {
+        static std::shared_mutex s_structure_mutex{};
+        return s_structure_mutex;
+    }
+
+    /* all sampled adapters, for the sampling load controller */
+    static std::mutex s_sampled_mutex{};
+    static std::vector<const SampledAdapter *> s_sampled{};
+
+    static std::atomic<double> s_stretch{1.0};
+
+    /* number of unchanged samples after which the interval of a property is doubled, and the maximum factor */
+    static constexpr uint32_t s_backoff_after = 4;
+    static constexpr uint32_t s_max_backoff = 64;
+
+    static int64_t thread_cpu_time()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    size_t SampledAdapter::sample_from(const Adapter *source, std::chrono::nanoseconds base_interval, std::optional<int64_t> time)
+    {
+        std::lock_guard<std::mutex> lock{m_sample_mutex};
+        auto &map = Adapter::map();
+        size_t count = 0;
+        for (size_t i = 0; i < dynamic_properties().size(); ++i) {
+            rate &r = m_rates[i];
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (base_interval.count() > 0 && now < r.next_due) {
+                // the reading is skipped, but the history gets a sample every tick
+                m_slots[i].carry(time.value_or(now));
+                continue;
+            }
+
+            auto *property = dynamic_cast<Property<uint64_t> *>(map.at(dynamic_properties()[i]));
+            int64_t start = thread_cpu_time();
+            auto value = property->value(const_cast<Adapter *>(source));
+            int64_t cost = thread_cpu_time() - start;
+
+            bool changed = false;
+            if (value.has_value()) {
+                auto previous = m_slots[i].read();
+                changed = !previous.has_value() || previous->value != *value;
+                int64_t sample_time = time.value_or(now);
+                m_slots[i].write(*value, sample_time);
+                if (SampleRecorder *recorder = sample_recorder()) {
+                    recorder->record(m_graph, m_vd, i, sample_time, *value);
+                }
+                if (changed) {
+                    update_rollups(m_graph, m_vd, i, *value);
+                    update_triggers(m_graph, m_vd, i, *value, sample_time);
+                }
+                ++count;
+            }
+            if (base_interval.count() <= 0) {
+                continue;
+            }
+
+            // rarely changing properties back off, a change restores the base interval
+            if (changed) {
+                r.unchanged = 0;
+                r.backoff = 1;
+            } else if (++r.unchanged >= s_backoff_after) {
+                r.unchanged = 0;
+                r.backoff = std::min(r.backoff * 2, s_max_backoff);
+            }
+            int64_t previous_cost = r.cost.load(std::memory_order_relaxed);
+            r.cost.store(previous_cost == 0 ? cost : (4 * previous_cost + cost) / 5, std::memory_order_relaxed);
+
+            int64_t desired = base_interval.count() * r.backoff;
+            int64_t interval = static_cast<int64_t>(desired * s_stretch.load(std::memory_order_relaxed));
+            r.desired.store(desired, std::memory_order_relaxed);
+            r.interval.store(interval, std::memory_order_relaxed);
+            // due half a base interval early, so that the tick of the module does not miss it by jitter
+            r.next_due = now + interval - base_interval.count() / 2;
+        }
+        return count;
+    }
+
+    double SampledAdapter::desired_load() const
+    {
+        double load = 0;
+        for (const rate &r : m_rates) {
+            int64_t desired = r.desired.load(std::memory_order_relaxed);
+            if (desired > 0) {
+                load += static_cast<double>(r.cost.load(std::memory_order_relaxed)) / desired;
+            }
+        }
+        return load;
+    }
+
+    double sampling_budget()
+    {
+        static const double s_budget = [] {
+            const char *budget = std::getenv("YLOC_SAMPLING_BUDGET");
+            double percent = budget != nullptr ? std::strtod(budget, nullptr) : 0.5;
+            return (percent > 0 ? percent : 0.5) / 100;
+        }();
+        return s_budget;
+    }
+
+    double sampling_stretch()
+    {
+        return s_stretch.load(std::memory_order_relaxed);
+    }
+
+    void update_sampling_stretch()
+    {
+        double load = 0;
+        {
+            std::lock_guard<std::mutex> lock{s_sampled_mutex};
+            for (const auto *sampled : s_sampled) {
+                load += sampled->desired_load();
+            }
+        }
+        s_stretch.store(std::max(1.0, load / sampling_budget()), std::memory_order_relaxed);
+    }
+
+    std::vector<sampling_rate> sampling_rates(const Graph &g)
+    {
+        std::vector<sampling_rate> rates{};
+        for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+            const SampledAdapter *sampled = find_sampled_adapter(g[vd]);
+            if (sampled == nullptr) {
+                continue;
+            }
+            for (size_t i = 0; i < dynamic_properties().size(); ++i) {
+                if (sampled->interval(i).count() > 0) {
+                    rates.push_back({vd, dynamic_properties()[i], sampled->interval(i), sampled->cost(i)});
+                }
+            }
+        }
+        return rates;
+    }
+
+    SampledAdapter *sampled_adapter(Graph &g, vertex_descriptor_t vd)
+    {
+        Vertex &v = g[vd];
+        if (auto *sampled = const_cast<SampledAdapter *>(find_sampled_adapter(v))) {
+            return sampled;
+        }
+        auto *sampled = new SampledAdapter{g, vd};
+        v.m_adapters.insert(v.m_adapters.begin(), sampled);
+        std::lock_guard<std::mutex> lock{s_sampled_mutex};
+        s_sampled.push_back(sampled);
+        return sampled;
+    }
+
+    const SampledAdapter *find_sampled_adapter(const Vertex &v)
+    {
+        return v.m_adapters.empty() ? nullptr : dynamic_cast<const SampledAdapter *>(v.m_adapters.front());
+    }
+
+    std::optional<aggregate> window_statistics(const Vertex &v, std::string_view property, std::chrono::nanoseconds window, resolution r)
+    {
+        const SampledAdapter *sampled = find_sampled_adapter(v);
+        const TimeSeries *series = sampled != nullptr ? sampled->series(property) : nullptr;
+        return series != nullptr ? series->statistics(window, r) : std::nullopt;
+    }
+
+    static constexpr std::chrono::seconds s_controller_interval{1};
+
+    void Sampler::start(size_t num_threads)
+    {
+        if (running()) {
+            return;
+        }
+        m_stop = false;
+        m_queue.clear();
+        auto now = clock::now();
+        for (auto *m : m_modules) {
+            if (m->m_enabled && m->m_update_interval.count() > 0) {
+                m_queue.push_back({now, m});
+            }
+        }
+        if (m_queue.empty()) {
+            return;
+        }
+        if (num_threads == 0) {
+            num_threads = std::min<size_t>(m_queue.size(), 4);
+        }
+        // the sampling load controller (see update_sampling_stretch())
+        m_queue.push_back({now + s_controller_interval, nullptr});
+        std::make_heap(m_queue.begin(), m_queue.end(), later);
+
+        for (size_t i = 0; i < num_threads; ++i) {
+            m_threads.emplace_back(&Sampler::run, this);
+        }
+    }
+
+    void Sampler::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    void Sampler::run()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (!m_stop) {
+            if (m_queue.empty()) {
+                // all modules are being updated by other threads
+                m_cv.wait(lock);
+                continue;
+            }
+            clock::time_point due = m_queue.front().due;
+            if (clock::now() < due) {
+                m_cv.wait_until(lock, due);
+                continue;
+            }
+            std::pop_heap(m_queue.begin(), m_queue.end(), later);
+            entry next = m_queue.back();
+            m_queue.pop_back();
+
+            lock.unlock();
+            if (next.module != nullptr && next.module->m_structural) {
+                next.module->update_graph(m_graph); // holds the structure exclusively itself
+            } else if (next.module != nullptr) {
+                std::shared_lock<std::shared_mutex> structure_lock{structure_mutex()};
+                next.module->update_graph(m_graph);
+            } else {
+                update_sampling_stretch();
+                if (SampleRecorder *recorder = sample_recorder()) {
+                    recorder->flush_blocks();
+                }
+            }
+            lock.lock();
+
+            // keep the period, but skip updates that were missed by a slow module
+            auto now = clock::now();
+            next.due += next.module != nullptr ? next.module->m_update_interval : s_controller_interval;
+            if (next.due < now) {
+                next.due = now;
+            }
+            m_queue.push_back(next);
+            std::push_heap(m_queue.begin(), m_queue.end(), later);
+            m_cv.notify_one();
+        }
+    }
+}
@@ -0,0 +1,540 @@
+#include <yloc/sampling.h>
+#include <yloc/series_file.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace yloc
+{
+    /* file layout: file_magic, then records (series definitions, blocks), then index records and the trailer */
+    static constexpr char s_file_magic[8] = {'Y', 'L', 'O', 'C', 'T', 'S', '0', '1'};
+    static constexpr uint32_t s_series_magic = 0x52455359; // "YSER"
+    static constexpr uint32_t s_block_magic = 0x4b4c4259;  // "YBLK"
+    static constexpr uint32_t s_index_magic = 0x58444959;  // "YIDX"
+    static constexpr uint32_t s_end_magic = 0x444e4559;    // "YEND"
+
+    struct series_header {
+        uint32_t magic;
+        uint32_t id;
+        uint32_t name_size; // vertex '\0' property
+    };
+
+    struct block_header {
+        uint32_t magic;
+        uint32_t series;
+        uint32_t count;
+        uint32_t time_size; // bytes of the timestamp column, followed by the value column
+        uint32_t value_size;
+        uint32_t padding;
+        int64_t min_time;
+        int64_t max_time;
+    };
+
+    struct index_entry {
+        uint32_t series;
+        uint32_t padding;
+        int64_t min_time;
+        int64_t max_time;
+        uint64_t offset;
+    };
+
+    struct trailer {
+        uint64_t index_offset;
+        uint32_t num_blocks;
+        uint32_t magic;
+    };
+
+    class BitWriter
+    {
+    public:
+        void write(uint64_t bits, int count)
+        {
+            for (int i = count - 1; i >= 0; --i) {
+                if (m_used == 0) {
+                    m_bytes.push_back(0);
+                }
+                m_bytes.back() |= static_cast<char>(((bits >> i) & 1) << (7 - m_used));
+                m_used = (m_used + 1) % 8;
+            }
+        }
+
+        const std::string &bytes() const { return m_bytes; }
+
+    private:
+        std::string m_bytes{};
+        int m_used{0}; // bits used in the last byte
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const char *data, size_t size) : m_data{data}, m_size{size} {}
+
+        uint64_t read(int count)
+        {
+            uint64_t bits = 0;
+            for (int i = 0; i < count; ++i) {
+                size_t byte = m_position / 8;
+                uint64_t bit = byte < m_size ? (static_cast<uint8_t>(m_data[byte]) >> (7 - m_position % 8)) & 1 : 0;
+                bits = (bits << 1) | bit;
+                ++m_position;
+            }
+            return bits;
+        }
+
+    private:
+        const char *m_data;
+        size_t m_size;
+        size_t m_position{0};
+    };
+
+    /* delta-of-delta buckets for nanosecond timestamps: control bits and signed value bits */
+    static constexpr struct {
+        uint64_t control;
+        int control_bits;
+        int value_bits;
+    } s_time_buckets[] = {{0b10, 2, 14}, {0b110, 3, 20}, {0b1110, 4, 32}, {0b1111, 4, 64}};
+
+    static void encode_times(BitWriter &w, const std::vector<sample> &samples)
+    {
+        int64_t previous_time = samples[0].time;
+        int64_t previous_delta = 0;
+        for (size_t i = 1; i < samples.size(); ++i) {
+            int64_t delta = samples[i].time - previous_time;
+            int64_t dod = delta - previous_delta;
+            if (dod == 0) {
+                w.write(0, 1);
+            } else {
+                for (const auto &bucket : s_time_buckets) {
+                    int64_t limit = bucket.value_bits == 64 ? INT64_MAX : (int64_t{1} << (bucket.value_bits - 1)) - 1;
+                    if (bucket.value_bits == 64 || (dod >= -limit - 1 && dod <= limit)) {
+                        w.write(bucket.control, bucket.control_bits);
+                        w.write(static_cast<uint64_t>(dod), bucket.value_bits);
+                        break;
+                    }
+                }
+            }
+            previous_time = samples[i].time;
+            previous_delta = delta;
+        }
+    }
+
+    static void decode_times(BitReader &r, std::vector<sample> &samples, int64_t first_time)
+    {
+        int64_t time = first_time;
+        int64_t delta = 0;
+        samples[0].time = time;
+        for (size_t i = 1; i < samples.size(); ++i) {
+            int64_t dod = 0;
+            if (r.read(1) != 0) {
+                int ones = 1;
+                while (ones < 4 && r.read(1) != 0) {
+                    ++ones;
+                }
+                int value_bits = s_time_buckets[ones - 1].value_bits;
+                uint64_t bits = r.read(value_bits);
+                // sign extension
+                dod = value_bits == 64 ? static_cast<int64_t>(bits) : static_cast<int64_t>(bits << (64 - value_bits)) >> (64 - value_bits);
+            }
+            delta += dod;
+            time += delta;
+            samples[i].time = time;
+        }
+    }
+
+    static int leading_zeros(uint64_t x) { return x == 0 ? 64 : __builtin_clzll(x); }
+    static int trailing_zeros(uint64_t x) { return x == 0 ? 64 : __builtin_ctzll(x); }
+
+    static void encode_values(BitWriter &w, const std::vector<sample> &samples)
+    {
+        uint64_t previous = samples[0].value;
+        w.write(previous, 64);
+        int previous_leading = -1, previous_trailing = 0;
+        for (size_t i = 1; i < samples.size(); ++i) {
+            uint64_t x = samples[i].value ^ previous;
+            if (x == 0) {
+                w.write(0, 1);
+            } else {
+                int leading = std::min(leading_zeros(x), 63);
+                int trailing = trailing_zeros(x);
+                w.write(1, 1);
+                if (previous_leading >= 0 && leading >= previous_leading && trailing >= previous_trailing) {
+                    // the meaningful bits fit into the window of the previous value
+                    w.write(0, 1);
+                    w.write(x >> previous_trailing, 64 - previous_leading - previous_trailing);
+                } else {
+                    int meaningful = 64 - leading - trailing;
+                    w.write(1, 1);
+                    w.write(leading, 6);
+                    w.write(meaningful - 1, 6);
+                    w.write(x >> trailing, meaningful);
+                    previous_leading = leading;
+                    previous_trailing = trailing;
+                }
+            }
+            previous = samples[i].value;
+        }
+    }
+
+    static void decode_values(BitReader &r, std::vector<sample> &samples)
+    {
+        uint64_t value = r.read(64);
+        samples[0].value = value;
+        int leading = 0, trailing = 0;
+        for (size_t i = 1; i < samples.size(); ++i) {
+            if (r.read(1) != 0) {
+                if (r.read(1) != 0) {
+                    leading = static_cast<int>(r.read(6));
+                    int meaningful = static_cast<int>(r.read(6)) + 1;
+                    trailing = 64 - leading - meaningful;
+                }
+                value ^= r.read(64 - leading - trailing) << trailing;
+            }
+            samples[i].value = value;
+        }
+    }
+
+    yloc_status_t SeriesFileWriter::open(const std::string &path)
+    {
+        close();
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file) {
+            return YLOC_STATUS_INVALID_ARGS;
+        }
+        m_file.write(s_file_magic, sizeof(s_file_magic));
+        m_file.flush();
+        return YLOC_STATUS_SUCCESS;
+    }
+
+    uint32_t SeriesFileWriter::add_series(const std::string &vertex, std::string_view property)
+    {
+        uint32_t id = static_cast<uint32_t>(m_names.size());
+        std::string name = vertex + '\0' + std::string{property};
+        m_names.push_back(name);
+        m_buffers.emplace_back();
+
+        series_header header{s_series_magic, id, static_cast<uint32_t>(name.size())};
+        m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_file.write(name.data(), name.size());
+        m_file.flush();
+        return id;
+    }
+
+    void SeriesFileWriter::append(uint32_t series, int64_t time, uint64_t value)
+    {
+        auto &buffer = m_buffers[series];
+        buffer.push_back({value, time});
+        if (buffer.size() == block_capacity) {
+            write_block(series);
+        }
+    }
+
+    void SeriesFileWriter::write_block(uint32_t series)
+    {
+        auto &buffer = m_buffers[series];
+        if (buffer.empty()) {
+            return;
+        }
+        BitWriter times{}, values{};
+        encode_times(times, buffer);
+        encode_values(values, buffer);
+
+        block_header header{s_block_magic, series, static_cast<uint32_t>(buffer.size()), static_cast<uint32_t>(times.bytes().size()),
+                            static_cast<uint32_t>(values.bytes().size()), 0, buffer.front().time, buffer.back().time};
+        m_index.push_back({series, header.min_time, header.max_time, static_cast<uint64_t>(m_file.tellp())});
+        m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_file.write(times.bytes().data(), times.bytes().size());
+        m_file.write(values.bytes().data(), values.bytes().size());
+        m_file.flush();
+        buffer.clear();
+    }
+
+    void SeriesFileWriter::flush()
+    {
+        for (uint32_t series = 0; series < m_buffers.size(); ++series) {
+            write_block(series);
+        }
+    }
+
+    void SeriesFileWriter::flush(int64_t time)
+    {
+        for (uint32_t series = 0; series < m_buffers.size(); ++series) {
+            if (!m_buffers[series].empty() && m_buffers[series].front().time < time) {
+                write_block(series);
+            }
+        }
+    }
+
+    void SeriesFileWriter::close()
+    {
+        if (!m_file.is_open()) {
+            return;
+        }
+        flush();
+        uint64_t index_offset = m_file.tellp();
+        uint32_t num_series = static_cast<uint32_t>(m_names.size());
+        m_file.write(reinterpret_cast<const char *>(&s_index_magic), sizeof(s_index_magic));
+        m_file.write(reinterpret_cast<const char *>(&num_series), sizeof(num_series));
+        for (const auto &name : m_names) {
+            uint32_t size = static_cast<uint32_t>(name.size());
+            m_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            m_file.write(name.data(), size);
+        }
+        for (const auto &block : m_index) {
+            index_entry entry{block.series, 0, block.min_time, block.max_time, block.offset};
+            m_file.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        }
+        trailer t{index_offset, static_cast<uint32_t>(m_index.size()), s_end_magic};
+        m_file.write(reinterpret_cast<const char *>(&t), sizeof(t));
+        m_file.close();
+        m_names.clear();
+        m_buffers.clear();
+        m_index.clear();
+    }
+
+    /* splits "vertex\0property" */
+    static SeriesFileReader::series_info make_series_info(uint32_t id, const std::string &name)
+    {
+        size_t separator = name.find('\0');
+        if (separator == std::string::npos) {
+            return {id, name, {}};
+        }
+        return {id, name.substr(0, separator), name.substr(separator + 1)};
+    }
+
+    yloc_status_t SeriesFileReader::open(const std::string &path)
+    {
+        m_file.open(path, std::ios::binary);
+        char magic[sizeof(s_file_magic)];
+        if (!m_file || !m_file.read(magic, sizeof(magic)) || std::memcmp(magic, s_file_magic, sizeof(magic)) != 0) {
+            return YLOC_STATUS_INVALID_ARGS;
+        }
+        m_file.seekg(0, std::ios::end);
+        uint64_t file_size = m_file.tellg();
+        if (!read_footer(file_size) && !scan_records(file_size)) {
+            return YLOC_STATUS_INVALID_ARGS;
+        }
+
+        bool first = true;
+        for (auto &blocks : m_blocks) {
+            std::sort(blocks.begin(), blocks.end(), [](const block_index &a, const block_index &b) { return a.min_time < b.min_time; });
+            for (const auto &block : blocks) {
+                m_min_time = first ? block.min_time : std::min(m_min_time, block.min_time);
+                m_max_time = first ? block.max_time : std::max(m_max_time, block.max_time);
+                first = false;
+            }
+        }
+        return YLOC_STATUS_SUCCESS;
+    }
+
+    bool SeriesFileReader::read_footer(uint64_t file_size)
+    {
+        trailer t;
+        if (file_size < sizeof(s_file_magic) + sizeof(t)) {
+            return false;
+        }
+        m_file.clear();
+        m_file.seekg(file_size - sizeof(t));
+        if (!m_file.read(reinterpret_cast<char *>(&t), sizeof(t)) || t.magic != s_end_magic || t.index_offset >= file_size) {
+            return false;
+        }
+
+        m_file.seekg(t.index_offset);
+        uint32_t magic, num_series;
+        m_file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+        m_file.read(reinterpret_cast<char *>(&num_series), sizeof(num_series));
+        if (!m_file || magic != s_index_magic) {
+            return false;
+        }
+        for (uint32_t id = 0; id < num_series; ++id) {
+            uint32_t size;
+            m_file.read(reinterpret_cast<char *>(&size), sizeof(size));
+            std::string name(size, '\0');
+            m_file.read(name.data(), size);
+            m_series.push_back(make_series_info(id, name));
+        }
+        m_blocks.resize(num_series);
+        for (uint32_t b = 0; b < t.num_blocks; ++b) {
+            index_entry entry;
+            m_file.read(reinterpret_cast<char *>(&entry), sizeof(entry));
+            if (entry.series < num_series) {
+                m_blocks[entry.series].push_back({entry.min_time, entry.max_time, entry.offset});
+            }
+        }
+        if (!m_file) {
+            m_series.clear();
+            m_blocks.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool SeriesFileReader::scan_records(uint64_t file_size)
+    {
+        // no index: the writer did not close the file, read the record headers up to the first incomplete record
+        m_file.clear();
+        uint64_t offset = sizeof(s_file_magic);
+        while (offset + sizeof(uint32_t) <= file_size) {
+            m_file.seekg(offset);
+            uint32_t magic;
+            m_file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+            m_file.seekg(offset);
+            if (magic == s_series_magic) {
+                series_header header;
+                if (!m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) || offset + sizeof(header) + header.name_size > file_size) {
+                    break;
+                }
+                std::string name(header.name_size, '\0');
+                m_file.read(name.data(), header.name_size);
+                m_series.push_back(make_series_info(header.id, name));
+                m_blocks.resize(m_series.size());
+                offset += sizeof(header) + header.name_size;
+            } else if (magic == s_block_magic) {
+                block_header header;
+                if (!m_file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+                    break;
+                }
+                uint64_t end = offset + sizeof(header) + header.time_size + header.value_size;
+                if (end > file_size || header.series >= m_blocks.size()) {
+                    break;
+                }
+                m_blocks[header.series].push_back({header.min_time, header.max_time, offset});
+                offset = end;
+            } else {
+                break;
+            }
+        }
+        m_file.clear();
+        return !m_series.empty();
+    }
+
+    std::optional<uint32_t> SeriesFileReader::find(std::string_view vertex, std::string_view property) const
+    {
+        for (const auto &info : m_series) {
+            if (info.vertex == vertex && info.property == property) {
+                return info.id;
+            }
+        }
+        return {};
+    }
+
+    std::vector<sample> SeriesFileReader::scan(uint32_t series, int64_t from, int64_t to)
+    {
+        std::vector<sample> result{};
+        if (series >= m_blocks.size()) {
+            return result;
+        }
+        for (const auto &block : m_blocks[series]) {
+            if (block.max_time < from || block.min_time > to) {
+                continue;
+            }
+            block_header header;
+            m_file.clear();
+            m_file.seekg(block.offset);
+            if (!m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != s_block_magic || header.count == 0) {
+                continue;
+            }
+            std::string data(header.time_size + header.value_size, '\0');
+            if (!m_file.read(data.data(), data.size())) {
+                continue;
+            }
+            ++m_blocks_read;
+
+            std::vector<sample> samples(header.count);
+            BitReader times{data.data(), header.time_size};
+            decode_times(times, samples, header.min_time);
+            BitReader values{data.data() + header.time_size, header.value_size};
+            decode_values(values, samples);
+            for (const sample &s : samples) {
+                if (s.time >= from && s.time <= to) {
+                    result.push_back(s);
+                }
+            }
+        }
+        return result;
+    }
+
+    yloc_status_t SampleRecorder::open(const Graph &g, const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        yloc_status_t status = m_writer.open(path);
+        if (status != YLOC_STATUS_SUCCESS) {
+            return status;
+        }
+        m_graph = &g;
+        m_series.clear();
+        m_vertex_names.assign(boost::num_vertices(g), {});
+        for (const auto &[id, vd] : g.identifier_map()) {
+            if (vd < m_vertex_names.size()) {
+                m_vertex_names[vd] = id;
+            }
+        }
+        for (vertex_descriptor_t vd = 0; vd < m_vertex_names.size(); ++vd) {
+            if (m_vertex_names[vd].empty()) {
+                m_vertex_names[vd] = "vd:" + std::to_string(vd);
+            }
+        }
+        auto system_now = std::chrono::system_clock::now().time_since_epoch();
+        auto steady_now = std::chrono::steady_clock::now().time_since_epoch();
+        m_clock_offset = std::chrono::duration_cast<std::chrono::nanoseconds>(system_now - steady_now).count();
+        return YLOC_STATUS_SUCCESS;
+    }
+
+    void SampleRecorder::record(const Graph &g, vertex_descriptor_t vd, size_t property, int64_t time, uint64_t value)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (&g != m_graph || !m_writer.is_open() || vd >= m_vertex_names.size()) {
+            return;
+        }
+        uint64_t key = (static_cast<uint64_t>(vd) << 8) | property;
+        auto iter = m_series.find(key);
+        if (iter == m_series.end()) {
+            iter = m_series.emplace(key, m_writer.add_series(m_vertex_names[vd], dynamic_properties()[property])).first;
+        }
+        m_writer.append(iter->second, time + m_clock_offset, value);
+    }
+
+    void SampleRecorder::flush_blocks()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_writer.is_open()) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now().time_since_epoch() - max_block_age;
+        m_writer.flush(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() + m_clock_offset);
+    }
+
+    void SampleRecorder::close()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_writer.close();
+        m_graph = nullptr;
+    }
+
+    /* the recorder is never destroyed, so samplers may hold it while recording is stopped */
+    static SampleRecorder s_recorder{};
+    static std::atomic<SampleRecorder *> s_active_recorder{nullptr};
+
+    SampleRecorder *sample_recorder()
+    {
+        return s_active_recorder.load(std::memory_order_acquire);
+    }
+
+    yloc_status_t start_recording(const Graph &g, const std::string &path)
+    {
+        stop_recording();
+        yloc_status_t status = s_recorder.open(g, path);
+        if (status == YLOC_STATUS_SUCCESS) {
+            s_active_recorder.store(&s_recorder, std::memory_order_release);
+        }
+        return status;
+    }
+
+    void stop_recording()
+    {
+        s_active_recorder.store(nullptr, std::memory_order_release);
+        s_recorder.close();
+    }
+}
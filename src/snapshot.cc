@@ -0,0 +1,497 @@
+#include <yloc/snapshot.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+using namespace yloc;
+
+static constexpr char s_magic[8] = {'Y', 'L', 'O', 'C', 'S', 'N', 'A', 'P'};
+static constexpr uint32_t s_version = 1;
+static constexpr uint32_t s_none = UINT32_MAX;
+
+/* static properties of the machine model stored in snapshots, property i is present if bit i of snapshot_vertex::present is set */
+static const char *const s_properties[] = {"memory", "bdfid", "numa_affinity", "bandwidth", "latency", "memory_tier", "frequency", "efficiency_class"};
+static constexpr size_t s_num_properties = std::size(s_properties);
+static constexpr uint32_t s_mask_present = 1u << 31;
+
+const std::vector<std::string_view> &yloc::static_properties()
+{
+    static const std::vector<std::string_view> properties{std::begin(s_properties), std::end(s_properties)};
+    return properties;
+}
+
+/* all offsets are relative to the beginning of the snapshot, strings are referenced by offset into the string section */
+struct snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t mask_bytes;
+    uint64_t size;
+    uint32_t num_types;
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    uint32_t num_tables;
+    uint32_t num_cpu_kinds;
+    uint32_t root;
+    uint64_t types;
+    uint64_t vertices;
+    uint64_t edges;
+    uint64_t masks;
+    uint64_t tables;
+    uint64_t cpu_kinds;
+    uint64_t strings;
+};
+
+struct snapshot_vertex {
+    uint32_t type;
+    uint32_t description;
+    uint32_t identifier;
+    uint32_t present;
+    uint64_t values[s_num_properties];
+};
+
+struct snapshot_edge {
+    uint32_t source;
+    uint32_t target;
+    uint32_t type;
+    uint32_t padding;
+};
+
+/* followed by the vertex indices (padded to 8 bytes) and the row-major values */
+struct snapshot_table {
+    uint32_t name;
+    uint32_t kind;
+    uint32_t num_vertices;
+    uint32_t padding;
+};
+
+static size_t align8(size_t n)
+{
+    return (n + 7) & ~size_t{7};
+}
+
+namespace
+{
+    class snapshot_writer
+    {
+    public:
+        template <class T>
+        size_t append(const T *items, size_t count)
+        {
+            size_t offset = m_buffer.size();
+            m_buffer.resize(align8(offset + sizeof(T) * count));
+            std::memcpy(m_buffer.data() + offset, items, sizeof(T) * count);
+            return offset;
+        }
+
+        /* deduplicated string, returns its offset in the string section */
+        uint32_t string(const std::string &s)
+        {
+            auto iter = m_string_offsets.find(s);
+            if (iter != m_string_offsets.end()) {
+                return iter->second;
+            }
+            uint32_t offset = static_cast<uint32_t>(m_strings.size());
+            m_strings.insert(m_strings.end(), s.c_str(), s.c_str() + s.size() + 1);
+            m_string_offsets[s] = offset;
+            return offset;
+        }
+
+        size_t offset() const { return m_buffer.size(); }
+
+        std::vector<char> &buffer() { return m_buffer; }
+
+        const std::vector<char> &strings() const { return m_strings; }
+
+    private:
+        std::vector<char> m_buffer{};
+        std::vector<char> m_strings{};
+        std::unordered_map<std::string, uint32_t> m_string_offsets{};
+    };
+
+    /** @brief Adapter serving the static properties of a snapshot vertex from the snapshot memory. */
+    class SnapshotAdapter : public Adapter
+    {
+    public:
+        SnapshotAdapter(const snapshot_vertex *vertex, const char *mask, const char *strings)
+            : m_vertex{vertex}, m_mask{mask}, m_strings{strings} {}
+
+        std::string to_string() const override { return m_strings + m_vertex->description; }
+
+        std::string_view description() const override { return m_strings + m_vertex->description; }
+
+#define SNAPSHOT_PROPERTY(index, name)                                 \
+    std::optional<uint64_t> name() const override                      \
+    {                                                                  \
+        static_assert(index < s_num_properties, "unknown property");   \
+        if ((m_vertex->present & (1u << index)) == 0) {                \
+            return {};                                                 \
+        }                                                              \
+        return m_vertex->values[index];                                \
+    }
+
+        SNAPSHOT_PROPERTY(0, memory)
+        SNAPSHOT_PROPERTY(1, bdfid)
+        SNAPSHOT_PROPERTY(2, numa_affinity)
+        SNAPSHOT_PROPERTY(3, bandwidth)
+        SNAPSHOT_PROPERTY(4, latency)
+        SNAPSHOT_PROPERTY(5, memory_tier)
+        SNAPSHOT_PROPERTY(6, frequency)
+        SNAPSHOT_PROPERTY(7, efficiency_class)
+
+#undef SNAPSHOT_PROPERTY
+
+        std::optional<AffinityMask> cpu_affinity_mask() const override
+        {
+            if ((m_vertex->present & s_mask_present) == 0) {
+                return {};
+            }
+            AffinityMask mask{};
+            std::memcpy(static_cast<void *>(&mask), m_mask, sizeof(AffinityMask));
+            return mask;
+        }
+
+    private:
+        const snapshot_vertex *m_vertex;
+        const char *m_mask;
+        const char *m_strings;
+    };
+}
+
+/**
+ * @brief Writes the subgraph induced by vertices, vertices[0] being its root.
+ *
+ * With anonymous_root the identifier and description of the root are omitted, so that
+ * snapshots of identical machines with different hostnames are byte-identical.
+ */
+static std::vector<char> write_snapshot(const Graph &g, const std::vector<vertex_descriptor_t> &vertices, uint32_t root, bool anonymous_root)
+{
+    snapshot_writer w{};
+    snapshot_header header{};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.mask_bytes = sizeof(AffinityMask);
+    header.root = root;
+    w.append(&header, 1);
+
+    std::vector<uint32_t> index(boost::num_vertices(g), s_none);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        index[vertices[i]] = static_cast<uint32_t>(i);
+    }
+
+    std::unordered_map<vertex_descriptor_t, std::string> identifiers{};
+    for (const auto &[id, vd] : g.identifier_map()) {
+        identifiers[vd] = id;
+    }
+
+    std::unordered_map<const Component *, uint32_t> type_index{};
+    std::vector<uint32_t> types{};
+    std::vector<snapshot_vertex> snapshot_vertices{};
+    std::vector<AffinityMask> masks{};
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex &v = g[vertices[i]];
+        auto type = type_index.find(v.type);
+        if (type == type_index.end()) {
+            type = type_index.insert({v.type, static_cast<uint32_t>(types.size())}).first;
+            types.push_back(w.string(v.type->to_string()));
+        }
+
+        bool anonymous = anonymous_root && i == root;
+        snapshot_vertex sv{};
+        sv.type = type->second;
+        sv.description = w.string(anonymous ? std::string{} : std::string{v.description()});
+        auto id = identifiers.find(vertices[i]);
+        sv.identifier = id != identifiers.end() && !anonymous ? w.string(id->second) : s_none;
+        for (size_t p = 0; p < s_num_properties; ++p) {
+            auto value = v.get<uint64_t>(s_properties[p]);
+            if (value.has_value()) {
+                sv.present |= 1u << p;
+                sv.values[p] = value.value();
+            }
+        }
+        auto mask = v.get<AffinityMask>("cpu_affinity_mask");
+        if (mask.has_value()) {
+            sv.present |= s_mask_present;
+        }
+        masks.push_back(mask.value_or(AffinityMask{}));
+        snapshot_vertices.push_back(sv);
+    }
+
+    // the first parents of all vertices come first, so that they are the first parents again when loaded
+    std::vector<snapshot_edge> edges{};
+    for (bool first_parents : {true, false}) {
+        for (auto vd : vertices) {
+            for (auto ed : boost::make_iterator_range(boost::out_edges(vd, g))) {
+                uint32_t target = index[boost::target(ed, g)];
+                bool first_parent = g[ed].type == edge_type::CHILD && g.parent(boost::target(ed, g)) == vd;
+                if (target != s_none && first_parent == first_parents) {
+                    edges.push_back({index[vd], target, static_cast<uint32_t>(g[ed].type), 0});
+                }
+            }
+        }
+    }
+
+    header.num_types = static_cast<uint32_t>(types.size());
+    header.types = w.append(types.data(), types.size());
+    header.num_vertices = static_cast<uint32_t>(snapshot_vertices.size());
+    header.vertices = w.append(snapshot_vertices.data(), snapshot_vertices.size());
+    header.num_edges = static_cast<uint32_t>(edges.size());
+    header.edges = w.append(edges.data(), edges.size());
+    header.masks = w.append(masks.data(), masks.size());
+
+    // tables are ordered by name, so that equal graphs give equal snapshots
+    std::vector<std::pair<std::string, const DistanceTable *>> tables{};
+    for (const auto &[name, table] : g.distance_tables()) {
+        bool contained = std::all_of(table.vertices().begin(), table.vertices().end(), [&](auto vd) { return index[vd] != s_none; });
+        if (contained) {
+            tables.emplace_back(name, &table);
+        }
+    }
+    std::sort(tables.begin(), tables.end());
+
+    header.tables = w.offset();
+    for (const auto &[name, table] : tables) {
+        uint32_t n = static_cast<uint32_t>(table->vertices().size());
+        snapshot_table st{w.string(name), static_cast<uint32_t>(table->get_kind()), n, 0};
+        w.append(&st, 1);
+        std::vector<uint32_t> table_vertices{};
+        for (auto vd : table->vertices()) {
+            table_vertices.push_back(index[vd]);
+        }
+        w.append(table_vertices.data(), table_vertices.size());
+        std::vector<uint64_t> values(n * n);
+        for (uint32_t i = 0; i < n; ++i) {
+            for (uint32_t j = 0; j < n; ++j) {
+                values[i * n + j] = table->value(i, j).value_or(UINT64_MAX);
+            }
+        }
+        w.append(values.data(), values.size());
+        header.num_tables++;
+    }
+
+    header.cpu_kinds = w.offset();
+    for (const auto &kind : g.cpu_kinds()) {
+        std::vector<uint32_t> kind_vertices{0};
+        for (auto vd : kind) {
+            if (index[vd] != s_none) {
+                kind_vertices.push_back(index[vd]);
+            }
+        }
+        kind_vertices[0] = static_cast<uint32_t>(kind_vertices.size() - 1);
+        w.append(kind_vertices.data(), kind_vertices.size());
+        header.num_cpu_kinds++;
+    }
+
+    header.strings = w.append(w.strings().data(), w.strings().size());
+    header.size = w.offset();
+    std::memcpy(w.buffer().data(), &header, sizeof(header));
+    return std::move(w.buffer());
+}
+
+std::vector<char> yloc::make_snapshot(const Graph &g)
+{
+    std::vector<vertex_descriptor_t> vertices{};
+    for (auto vd : boost::make_iterator_range(boost::vertices(g))) {
+        vertices.push_back(vd);
+    }
+    return write_snapshot(g, vertices, static_cast<uint32_t>(g.get_root_vertex()), false);
+}
+
+std::vector<char> yloc::make_snapshot(const Graph &g, const std::vector<vertex_descriptor_t> &vertices)
+{
+    return write_snapshot(g, vertices, 0, true);
+}
+
+/* true if count items of item_size bytes starting at the aligned offset lie before end */
+static bool in_bounds(uint64_t offset, uint64_t count, uint64_t item_size, uint64_t end)
+{
+    return offset % 8 == 0 && offset <= end && count <= (end - offset) / item_size;
+}
+
+/**
+ * @brief Checks all offsets, counts and indices of a snapshot before it is read.
+ *
+ * Snapshots are received from other processes (see load_snapshot_at()), so a truncated or
+ * foreign buffer must not make the reader access memory outside of it.
+ */
+static bool valid_snapshot(const char *data, const snapshot_header &header)
+{
+    const uint64_t end = header.size;
+    if (header.strings < sizeof(header) || header.strings > end || (end > header.strings && data[end - 1] != '\0')) {
+        return false;
+    }
+    const uint64_t num_strings = end - header.strings; // bytes of the string section, terminated by its last byte
+    auto valid_string = [&](uint32_t offset) { return offset < num_strings; };
+
+    if (!in_bounds(header.types, header.num_types, sizeof(uint32_t), header.strings) ||
+        !in_bounds(header.vertices, header.num_vertices, sizeof(snapshot_vertex), header.strings) ||
+        !in_bounds(header.edges, header.num_edges, sizeof(snapshot_edge), header.strings) ||
+        !in_bounds(header.masks, header.num_vertices, sizeof(AffinityMask), header.strings) ||
+        (header.num_vertices != 0 && header.root >= header.num_vertices)) {
+        return false;
+    }
+
+    const auto *types = reinterpret_cast<const uint32_t *>(data + header.types);
+    if (!std::all_of(types, types + header.num_types, valid_string)) {
+        return false;
+    }
+    const auto *vertices = reinterpret_cast<const snapshot_vertex *>(data + header.vertices);
+    for (uint32_t i = 0; i < header.num_vertices; ++i) {
+        const snapshot_vertex &sv = vertices[i];
+        if (sv.type >= header.num_types || !valid_string(sv.description) || (sv.identifier != s_none && !valid_string(sv.identifier))) {
+            return false;
+        }
+    }
+    const auto *edges = reinterpret_cast<const snapshot_edge *>(data + header.edges);
+    for (uint32_t i = 0; i < header.num_edges; ++i) {
+        if (edges[i].source >= header.num_vertices || edges[i].target >= header.num_vertices ||
+            edges[i].type >= static_cast<uint32_t>(edge_type::EDGE_TYPE_MAX)) {
+            return false;
+        }
+    }
+
+    uint64_t offset = header.tables;
+    for (uint32_t t = 0; t < header.num_tables; ++t) {
+        if (!in_bounds(offset, 1, sizeof(snapshot_table), header.strings)) {
+            return false;
+        }
+        snapshot_table st;
+        std::memcpy(&st, data + offset, sizeof(st));
+        offset += sizeof(st);
+        uint32_t n = st.num_vertices;
+        if (!valid_string(st.name) || st.kind > static_cast<uint32_t>(DistanceTable::kind::BANDWIDTH) ||
+            n > header.num_vertices || !in_bounds(offset, n, sizeof(uint32_t), header.strings)) {
+            return false;
+        }
+        const auto *table_vertices = reinterpret_cast<const uint32_t *>(data + offset);
+        if (!std::all_of(table_vertices, table_vertices + n, [&](uint32_t i) { return i < header.num_vertices; })) {
+            return false;
+        }
+        offset += align8(n * sizeof(uint32_t));
+        if (n != 0 && !in_bounds(offset, n, uint64_t{n} * sizeof(uint64_t), header.strings)) {
+            return false;
+        }
+        offset += align8(uint64_t{n} * n * sizeof(uint64_t));
+    }
+
+    offset = header.cpu_kinds;
+    for (uint32_t k = 0; k < header.num_cpu_kinds; ++k) {
+        if (!in_bounds(offset, 1, sizeof(uint32_t), header.strings)) {
+            return false;
+        }
+        const auto *kind_vertices = reinterpret_cast<const uint32_t *>(data + offset);
+        uint32_t n = kind_vertices[0];
+        if (n > header.num_vertices || !in_bounds(offset, uint64_t{n} + 1, sizeof(uint32_t), header.strings) ||
+            !std::all_of(kind_vertices + 1, kind_vertices + 1 + n, [&](uint32_t i) { return i < header.num_vertices; })) {
+            return false;
+        }
+        offset += align8((uint64_t{n} + 1) * sizeof(uint32_t));
+    }
+    return true;
+}
+
+/**
+ * @brief Adds a snapshot to graph g.
+ *
+ * @param attach_root Existing vertex used for the snapshot's root, if any
+ * @param prefix Prefix of identifiers and table names, cpu kinds are skipped if not empty
+ */
+static yloc_status_t read_snapshot(Graph &g, const char *data, size_t size, std::optional<vertex_descriptor_t> attach_root, const std::string &prefix, vertex_descriptor_t *root)
+{
+    snapshot_header header;
+    if (size < sizeof(header)) {
+        return YLOC_STATUS_INVALID_ARGS;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != s_version ||
+        header.mask_bytes != sizeof(AffinityMask) || header.size > size || !valid_snapshot(data, header)) {
+        return YLOC_STATUS_INVALID_ARGS;
+    }
+
+    const char *strings = data + header.strings;
+    const auto *types = reinterpret_cast<const uint32_t *>(data + header.types);
+    const auto *vertices = reinterpret_cast<const snapshot_vertex *>(data + header.vertices);
+    const auto *edges = reinterpret_cast<const snapshot_edge *>(data + header.edges);
+
+    std::vector<vertex_descriptor_t> vds(header.num_vertices);
+    for (uint32_t i = 0; i < header.num_vertices; ++i) {
+        const snapshot_vertex &sv = vertices[i];
+        if (attach_root.has_value() && i == header.root) {
+            vds[i] = attach_root.value();
+        } else if (sv.identifier != s_none) {
+            vds[i] = g.add_vertex(prefix + (strings + sv.identifier));
+        } else {
+            vds[i] = g.add_vertex();
+        }
+        Vertex &v = g[vds[i]];
+        if (v.type == UnknownComponentType::ptr()) {
+            const Component *type = component_type(strings + types[sv.type]);
+            v.type = type != nullptr ? type : UnknownComponentType::ptr();
+        }
+        // the description is served from data as well (see Vertex::description())
+        v.add_adapter(new SnapshotAdapter{&sv, data + header.masks + i * sizeof(AffinityMask), strings});
+    }
+
+    // every relation is stored with both of its edges, the back edges are added by add_relation()
+    for (uint32_t i = 0; i < header.num_edges; ++i) {
+        auto kind = static_cast<edge_type>(edges[i].type);
+        if (kind != edge_type::PARENT) {
+            g.add_relation(vds[edges[i].source], vds[edges[i].target], kind);
+        }
+    }
+
+    uint64_t offset = header.tables;
+    for (uint32_t t = 0; t < header.num_tables; ++t) {
+        snapshot_table st;
+        std::memcpy(&st, data + offset, sizeof(st));
+        offset += sizeof(st);
+        const auto *table_vertices = reinterpret_cast<const uint32_t *>(data + offset);
+        offset += align8(st.num_vertices * sizeof(uint32_t));
+        const auto *values = reinterpret_cast<const uint64_t *>(data + offset);
+        offset += align8(uint64_t{st.num_vertices} * st.num_vertices * sizeof(uint64_t));
+
+        std::vector<vertex_descriptor_t> table_vds{};
+        for (uint32_t i = 0; i < st.num_vertices; ++i) {
+            table_vds.push_back(vds[table_vertices[i]]);
+        }
+        DistanceTable table{static_cast<DistanceTable::kind>(st.kind), std::move(table_vds)};
+        for (uint32_t i = 0; i < st.num_vertices; ++i) {
+            for (uint32_t j = 0; j < st.num_vertices; ++j) {
+                table.set(i, j, values[i * st.num_vertices + j]);
+            }
+        }
+        g.set_distance_table(prefix + (strings + st.name), std::move(table));
+    }
+
+    offset = header.cpu_kinds;
+    std::vector<std::vector<vertex_descriptor_t>> cpu_kinds(header.num_cpu_kinds);
+    for (auto &kind : cpu_kinds) {
+        const auto *kind_vertices = reinterpret_cast<const uint32_t *>(data + offset);
+        for (uint32_t i = 1; i <= kind_vertices[0]; ++i) {
+            kind.push_back(vds[kind_vertices[i]]);
+        }
+        offset += align8((uint64_t{kind_vertices[0]} + 1) * sizeof(uint32_t));
+    }
+    if (!cpu_kinds.empty() && prefix.empty()) {
+        g.set_cpu_kinds(std::move(cpu_kinds));
+    }
+
+    if (root != nullptr && header.root < header.num_vertices) {
+        *root = vds[header.root];
+    }
+    return YLOC_STATUS_SUCCESS;
+}
+
+yloc_status_t yloc::load_snapshot(Graph &g, const char *data, size_t size, vertex_descriptor_t *root)
+{
+    return read_snapshot(g, data, size, {}, {}, root);
+}
+
+yloc_status_t yloc::load_snapshot_at(Graph &g, vertex_descriptor_t root, const std::string &prefix, const char *data, size_t size)
+{
+    return read_snapshot(g, data, size, root, prefix, nullptr);
+}
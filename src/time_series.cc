@@ -0,0 +1,129 @@
+#include <yloc/time_series.h>
+
+#include <algorithm>
+
+namespace yloc
+{
+    static constexpr int64_t s_nanoseconds_per_second = 1000000000;
+    static constexpr int64_t s_nanoseconds_per_minute = 60 * s_nanoseconds_per_second;
+
+    static int64_t window_start(std::chrono::nanoseconds window)
+    {
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
+        return (now - window).count();
+    }
+
+    /* merges b into a, a.count == 0 for the first aggregate */
+    static void merge(aggregate &a, const aggregate &b)
+    {
+        if (a.count == 0) {
+            a = b;
+            return;
+        }
+        a.time = std::min(a.time, b.time);
+        a.min = std::min(a.min, b.min);
+        a.max = std::max(a.max, b.max);
+        a.mean = (a.mean * a.count + b.mean * b.count) / (a.count + b.count);
+        a.count += b.count;
+    }
+
+    void TimeSeries::open_aggregate::add(const sample &s, int64_t start)
+    {
+        if (value.count == 0) {
+            value.time = start;
+            value.min = s.value;
+            value.max = s.value;
+        } else {
+            value.min = std::min(value.min, s.value);
+            value.max = std::max(value.max, s.value);
+        }
+        sum += static_cast<double>(s.value);
+        value.count++;
+        value.mean = sum / value.count;
+    }
+
+    void TimeSeries::append(const sample &s)
+    {
+        m_raw.push(s);
+
+        // an interval is complete with the first sample of the next one
+        int64_t second = s.time - s.time % s_nanoseconds_per_second;
+        if (m_second.value.count != 0 && m_second.value.time != second) {
+            m_seconds.push(m_second.value);
+            m_second = open_aggregate{};
+        }
+        m_second.add(s, second);
+
+        int64_t minute = s.time - s.time % s_nanoseconds_per_minute;
+        if (m_minute.value.count != 0 && m_minute.value.time != minute) {
+            m_minutes.push(m_minute.value);
+            m_minute = open_aggregate{};
+        }
+        m_minute.add(s, minute);
+    }
+
+    std::vector<sample> TimeSeries::history(std::chrono::nanoseconds window) const
+    {
+        int64_t start = window_start(window);
+        std::vector<sample> samples{};
+        m_raw.visit_newest([&](const sample &s) {
+            if (s.time < start) {
+                return false;
+            }
+            samples.push_back(s);
+            return true;
+        });
+        std::reverse(samples.begin(), samples.end());
+        return samples;
+    }
+
+    std::vector<aggregate> TimeSeries::history(std::chrono::nanoseconds window, resolution r) const
+    {
+        if (r == resolution::RAW) {
+            std::vector<aggregate> aggregates{};
+            for (const sample &s : history(window)) {
+                aggregates.push_back({s.time, s.value, s.value, static_cast<double>(s.value), 1});
+            }
+            return aggregates;
+        }
+
+        int64_t start = window_start(window);
+        std::vector<aggregate> aggregates{};
+        (r == resolution::SECOND ? m_seconds : m_minutes).visit_newest([&](const aggregate &a) {
+            if (a.time < start) {
+                return false;
+            }
+            aggregates.push_back(a);
+            return true;
+        });
+        std::reverse(aggregates.begin(), aggregates.end());
+        return aggregates;
+    }
+
+    std::optional<aggregate> TimeSeries::statistics(std::chrono::nanoseconds window, resolution r) const
+    {
+        int64_t start = window_start(window);
+        aggregate result{};
+        if (r == resolution::RAW) {
+            double sum = 0;
+            m_raw.visit_newest([&](const sample &s) {
+                if (s.time < start) {
+                    return false;
+                }
+                merge(result, {s.time, s.value, s.value, 0, 1});
+                sum += static_cast<double>(s.value);
+                return true;
+            });
+            result.mean = result.count != 0 ? sum / result.count : 0;
+        } else {
+            (r == resolution::SECOND ? m_seconds : m_minutes).visit_newest([&](const aggregate &a) {
+                if (a.time < start) {
+                    return false;
+                }
+                merge(result, a);
+                return true;
+            });
+        }
+        return result.count != 0 ? std::optional<aggregate>{result} : std::nullopt;
+    }
+}
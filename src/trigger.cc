@@ -0,0 +1,84 @@
+#include <yloc/sampling.h>
+#include <yloc/trigger.h>
+
+#include <memory>
+#include <mutex>
+
+namespace yloc
+{
+    /* all triggers, the mutex also serializes their updates (i.e. the producers of their queues) */
+    static std::mutex s_triggers_mutex{};
+    static std::vector<std::unique_ptr<Trigger>> s_triggers{};
+    static std::atomic<size_t> s_num_triggers{0};
+
+    Trigger::Trigger(const Graph &g, const std::vector<vertex_descriptor_t> &vertices, size_t property, trigger_condition condition,
+                     uint64_t threshold, uint64_t hysteresis, callback_t callback, size_t queue_capacity)
+        : m_graph{g}, m_property{property}, m_condition{condition}, m_threshold{threshold}, m_hysteresis{hysteresis},
+          m_callback{std::move(callback)}, m_events{m_callback ? 0 : queue_capacity}, m_states(boost::num_vertices(g))
+    {
+        for (auto vd : vertices) {
+            if (vd < m_states.size()) {
+                m_states[vd].store(INACTIVE, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Trigger::update(vertex_descriptor_t vd, uint64_t value, int64_t time)
+    {
+        bool active = m_states[vd].load(std::memory_order_relaxed) == ACTIVE;
+        bool above = m_condition == trigger_condition::ABOVE;
+        if (!active) {
+            active = above ? value > m_threshold : value < m_threshold;
+        } else {
+            // cleared only beyond the hysteresis on the other side of the threshold
+            bool cleared = above ? value + m_hysteresis < m_threshold : value > m_threshold + m_hysteresis;
+            active = !cleared;
+        }
+        if (active == (m_states[vd].load(std::memory_order_relaxed) == ACTIVE)) {
+            return;
+        }
+        m_states[vd].store(active ? ACTIVE : INACTIVE, std::memory_order_relaxed);
+
+        trigger_event event{vd, value, time, active};
+        if (m_callback) {
+            m_callback(event);
+        } else {
+            m_events.push(event);
+        }
+    }
+
+    Trigger *add_trigger(const Graph &g, const std::vector<vertex_descriptor_t> &vertices, std::string_view property, trigger_condition condition,
+                         uint64_t threshold, uint64_t hysteresis, Trigger::callback_t callback, size_t queue_capacity)
+    {
+        auto index = dynamic_property_index(property);
+        if (!index.has_value()) {
+            return nullptr;
+        }
+        auto trigger = std::make_unique<Trigger>(g, vertices, *index, condition, threshold, hysteresis, std::move(callback), queue_capacity);
+
+        std::lock_guard<std::mutex> lock{s_triggers_mutex};
+        for (auto vd : vertices) {
+            const SampledAdapter *sampled = vd < boost::num_vertices(g) ? find_sampled_adapter(g[vd]) : nullptr;
+            auto latest = sampled != nullptr ? sampled->latest(*index) : std::nullopt;
+            if (latest.has_value()) {
+                trigger->update(vd, latest->value, latest->time);
+            }
+        }
+        s_triggers.push_back(std::move(trigger));
+        s_num_triggers.store(s_triggers.size(), std::memory_order_release);
+        return s_triggers.back().get();
+    }
+
+    void update_triggers(const Graph &g, vertex_descriptor_t vd, size_t property, uint64_t value, int64_t time)
+    {
+        if (s_num_triggers.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock{s_triggers_mutex};
+        for (const auto &trigger : s_triggers) {
+            if (&trigger->graph() == &g && trigger->property() == property && trigger->is_member(vd)) {
+                trigger->update(vd, value, time);
+            }
+        }
+    }
+}
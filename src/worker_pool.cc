@@ -0,0 +1,64 @@
+#include <yloc/worker_pool.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace yloc
+{
+    void WorkerPool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_tasks.push_back(std::move(task));
+            if (m_threads.empty()) {
+                m_stop = false;
+                for (size_t i = 0; i < m_num_threads; ++i) {
+                    m_threads.emplace_back(&WorkerPool::run, this);
+                }
+            }
+        }
+        m_cv.notify_one();
+    }
+
+    void WorkerPool::stop()
+    {
+        std::vector<std::thread> threads{};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_stop = true;
+            threads.swap(m_threads);
+        }
+        m_cv.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    void WorkerPool::run()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (true) {
+            m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;
+            }
+            auto task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    WorkerPool &async_workers()
+    {
+        static WorkerPool s_pool{[] {
+            const char *threads = std::getenv("YLOC_ASYNC_THREADS");
+            if (threads != nullptr && std::strtol(threads, nullptr, 10) > 0) {
+                return static_cast<size_t>(std::strtol(threads, nullptr, 10));
+            }
+            return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+        }()};
+        return s_pool;
+    }
+}